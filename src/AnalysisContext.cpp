@@ -0,0 +1,50 @@
+/**
+ * This implementation file contains the AnalysisContext class, which loads
+ * all read-only calibration, PID and energy loss information once so that it
+ * can be shared between worker tasks.
+ */
+
+#include "AnalysisContext.h"
+
+#include <iostream>
+#include <string>
+
+#include "histo.h"
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalysisContext::AnalysisContext(SortConfig& config) {
+	cout << "Loading calibrations, PID gates and energy loss tables..." << endl;
+
+	Targetdist = config.GetTargDist();
+	TargetThickness = config.GetTargThick();
+
+	// What each HINP channel is connected to. The Si calibrations below are
+	// indexed the same way, quadrant * channum + strip
+	static_assert(ChannelMap::NStrips == histo::channum && ChannelMap::NQuads == 4, "ChannelMap and the calibrations must agree on the number of strips");
+	channels = new ChannelMap(config.GetChannelMapFile());
+
+	// Si and diamond calibrations, TexNeut TDC shifts and PID banana gates of
+	// each calibration epoch, from sort.config and the calibration database
+	calibrations = new CalibrationDB(config);
+	calDither = config.GetCalDither();
+
+	// Range-energy PID, replaces the gates when enabled
+	linearPid = config.IsLinearPID() ? new LinearPID(config) : nullptr;
+
+	// Target energy loss tables, up to Z = 3
+	losses = new CLosses(3, config);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalysisContext::~AnalysisContext() {
+	delete channels;
+	delete calibrations;
+	delete linearPid;
+	delete losses;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
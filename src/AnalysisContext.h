@@ -0,0 +1,54 @@
+/**
+ * This header file contains the AnalysisContext class, which holds all of the
+ * read-only analysis inputs: the HINP channel map, the run-dependent
+ * calibrations (Si energy/time, diamond, TexNeut TDC shifts and PID banana
+ * gates, see CalibrationDB.h) and target energy loss tables. It is
+ * built once at startup and shared by reference between all worker tasks, so
+ * that these files are read from disk only once per process. Everything in
+ * here must stay immutable after construction, apart from the calibration
+ * sets that CalibrationDB loads on first use behind its own lock; per-event
+ * scratch state belongs in Gobbi/silicon, which are created per task.
+ */
+
+#ifndef AnalysisContext_H
+#define AnalysisContext_H
+
+#include "CalibrationDB.h"
+#include "ChannelMap.h"
+#include "LinearPID.h"
+#include "losses.h"
+#include "SortConfig.h"
+
+class AnalysisContext {
+
+public:
+	AnalysisContext(SortConfig& config);
+	~AnalysisContext();
+
+	// Not copyable, workers share one instance by reference
+	AnalysisContext(const AnalysisContext&) = delete;
+	AnalysisContext& operator=(const AnalysisContext&) = delete;
+
+	// Getters
+	const ChannelMap* GetChannelMap() const { return channels; }
+	const CalibrationDB* GetCalibrations() const { return calibrations; }
+	bool GetCalDither() const { return calDither; } // add a random fraction of a channel to raw energies
+	const LinearPID* GetLinearPid() const { return linearPid; } // nullptr unless pidMode = linear
+	const CLosses* GetLosses() const { return losses; }
+	float GetTargDist() const { return Targetdist; }
+	float GetTargThick() const { return TargetThickness; }
+
+private:
+	float Targetdist;
+	float TargetThickness;
+
+	ChannelMap* channels;  // HINP (board, chan) -> face, quadrant and strip
+	CalibrationDB* calibrations; // calibration set of each run, loaded on first use
+	bool calDither;
+
+	LinearPID* linearPid;
+	CLosses* losses;   // target energy loss tables
+
+};
+
+#endif
@@ -0,0 +1,80 @@
+/* Written for the bulk input path of the Input class. A BulkColumn reads
+ * one double-valued column of the SpecTcl tree a whole basket at a time
+ * using ROOT's bulk I/O, see BulkColumn.h for details.
+ */
+
+#include "BulkColumn.h"
+
+#include <Bytes.h>
+#include <ROOT/TBulkBranchRead.hxx>
+#include <TBranch.h>
+#include <TLeaf.h>
+#include <TMath.h>
+#include <TObjArray.h>
+#include <TTree.h>
+
+#include <cmath>
+#include <exception>
+#include <string>
+
+#include <stuffing.hpp>
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BulkColumn::BulkColumn(const string& n) : name(n) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BulkColumn::Attach(TTree* tree, TBufferFile* buf) {
+	buffer = buf;
+	first = 0;
+	last = 0;
+	values.clear();
+
+	leaf = tree->FindLeaf(name.c_str());
+	branch = leaf ? leaf->GetBranch() : tree->FindBranch(name.c_str());
+	if (!branch) throw invalid_argument(string(BOLDRED) + string("Column ") + name + string(" not found in input tree") + string(RESET));
+	if (!leaf) leaf = (TLeaf*)branch->GetListOfLeaves()->At(0);
+
+	// Bulk reading only works for branches holding a single fundamental value
+	bulk = branch->SupportsBulkRead() && leaf && leaf->GetNdata() == 1 && branch->GetListOfLeaves()->GetEntriesFast() == 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BulkColumn::Load(Long64_t entry) {
+
+	// Fallback: read only the requested entry through the leaf
+	if (!bulk) {
+		branch->GetEntry(entry);
+		first = entry;
+		last = entry + 1;
+		values.assign(1, leaf ? leaf->GetValue() : NAN);
+		return;
+	}
+
+	// Find the basket holding this entry, bulk reads always start at a basket boundary
+	Long64_t* basketEntry = branch->GetBasketEntry();
+	Long64_t ibasket = TMath::BinarySearch((Long64_t)branch->GetWriteBasket() + 1, basketEntry, entry);
+	if (ibasket < 0) ibasket = 0;
+	first = basketEntry[ibasket];
+
+	buffer->Reset();
+	Int_t count = branch->GetBulkRead().GetEntriesSerialized(first, *buffer);
+	if (count <= 0 || entry >= first + count) {
+		// Bulk read failed for this basket, use the leaf for the rest of the file
+		bulk = false;
+		Load(entry);
+		return;
+	}
+
+	// Values in the serialized buffer are big-endian doubles
+	values.resize(count);
+	char* raw = buffer->GetCurrent();
+	for (Int_t i = 0; i < count; i++) frombuf(raw, &values[i]);
+	last = first + count;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,54 @@
+#ifndef BulkColumn_H
+#define BulkColumn_H
+
+/* Written for the bulk input path of the Input class. A BulkColumn reads
+ * one double-valued column of the SpecTcl tree a whole basket at a time
+ * using ROOT's bulk I/O (TBranch::GetBulkRead), and keeps the decoded
+ * basket in a flat array so that per-event access is a single indexed
+ * load. Columns whose branch does not support bulk reading (e.g. leaves
+ * of a leaf-list branch) fall back to reading the leaf entry by entry.
+ */
+
+#include <TBufferFile.h>
+
+#include <string>
+#include <vector>
+
+class TBranch;
+class TLeaf;
+class TTree;
+
+class BulkColumn {
+
+public:
+	BulkColumn(const std::string& name);
+
+	// Resolve the column in a (new) tree and drop any cached basket. The
+	// serialization buffer is only scratch space and is shared between columns.
+	void Attach(TTree* tree, TBufferFile* buffer);
+
+	// Value of the column for a tree-local entry number
+	double Get(Long64_t entry) {
+		if (entry < first || entry >= last) Load(entry);
+		return values[entry - first];
+	}
+
+	bool IsBulk() const { return bulk; }
+
+private:
+	std::string name;
+	TBranch* branch{nullptr};
+	TLeaf* leaf{nullptr};
+	bool bulk{false};
+
+	// Decoded values for entries [first, last)
+	Long64_t first{0};
+	Long64_t last{0};
+	std::vector<double> values;
+	TBufferFile* buffer{nullptr};
+
+	void Load(Long64_t entry);
+
+};
+
+#endif
@@ -0,0 +1,269 @@
+/**
+ * This implementation file contains the CalibrationDB and CalibrationSet
+ * classes, which load the run-dependent calibrations of a job. See
+ * CalibrationDB.h and config/calibrations.config.
+ */
+
+#include "CalibrationDB.h"
+
+#include <algorithm>
+#include <climits>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <stuffing.hpp>
+
+#include "histo.h"
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool CalibrationSet::Settings::operator==(const Settings& other) const {
+	return frontEcalFile == other.frontEcalFile && backEcalFile == other.backEcalFile && deltaEcalFile == other.deltaEcalFile
+		&& frontTimecalFile == other.frontTimecalFile && backTimecalFile == other.backTimecalFile && deltaTimecalFile == other.deltaTimecalFile
+		&& diamondEcalFile == other.diamondEcalFile && PIDDir == other.PIDDir && pidCache == other.pidCache
+		&& diamondChannel == other.diamondChannel && tnTDCShift == other.tnTDCShift;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CalibrationSet::CalibrationSet(const Settings& settings, const string& calDir, bool tables) {
+
+	// Si and diamond calibrations, indexed quadrant * channum + strip like the channel map
+	FrontEcal = new calibrate(4, histo::channum, calDir + settings.frontEcalFile, 1, false);
+	BackEcal = new calibrate(4, histo::channum, calDir + settings.backEcalFile, 1, false);
+	DeltaEcal = new calibrate(4, histo::channum, calDir + settings.deltaEcalFile, 1, false);
+	FrontTimecal = new calibrate(4, histo::channum, calDir + settings.frontTimecalFile, 1, false);
+	BackTimecal = new calibrate(4, histo::channum, calDir + settings.backTimecalFile, 1, false);
+	DeltaTimecal = new calibrate(4, histo::channum, calDir + settings.deltaTimecalFile, 1, false);
+	DiamondEcal = new calibrate(1, 4, calDir + settings.diamondEcalFile, 1, false);
+	diamondChannel = settings.diamondChannel;
+	tnTDCShift = settings.tnTDCShift;
+
+	// Energies of every raw value, HINP and QDC values are 14 bit (Input
+	// drops anything from 16384 up)
+	if (tables) {
+		const int adcChannels = 16384;
+		for (calibrate* cal : {FrontEcal, BackEcal, DeltaEcal, DiamondEcal}) cal->BuildTable(adcChannels);
+	}
+
+	// PID banana gates, one zline file per quadrant, read through the binary
+	// gate cache unless it is turned off
+	vector<string> names;
+	for (int id = 0; id < 4; id++) names.push_back("pid_quad" + to_string(id + 1));
+	gates = nullptr;
+	if (settings.pidCache != "none") gates = new GateCache(settings.pidCache, settings.PIDDir, names);
+	for (int id = 0; id < 4; id++)
+		Pid[id] = gates ? new pid(*gates, names[id]) : new pid(names[id], settings.PIDDir);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CalibrationSet::~CalibrationSet() {
+	delete FrontEcal;
+	delete BackEcal;
+	delete DeltaEcal;
+	delete FrontTimecal;
+	delete BackTimecal;
+	delete DeltaTimecal;
+	delete DiamondEcal;
+	for (int id = 0; id < 4; id++) delete Pid[id];
+	delete gates;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Read "first-last", "first-" (no upper end) or a single run number
+static bool ParseRuns(const string& s, int& first, int& last) {
+	try {
+		size_t dash = s.find('-');
+		size_t pos;
+		first = stoi(s.substr(0, dash), &pos);
+		if (pos != min(dash, s.size())) return false;
+		if (dash == string::npos) last = first;
+		else if (dash + 1 == s.size()) last = INT_MAX;
+		else {
+			last = stoi(s.substr(dash + 1), &pos);
+			if (pos != s.size() - dash - 1) return false;
+		}
+	}
+	catch (...) {
+		return false;
+	}
+	return first >= 0 && last >= first;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Set key of s to values, false if the key is unknown or the values are invalid
+static bool Apply(const string& key, const vector<string>& values, CalibrationSet::Settings& s) {
+	if (key == "tnTDCShift") {
+		if (values.size() != CalibrationSet::NTNTDC) return false;
+		try {
+			for (size_t i = 0; i < values.size(); i++) s.tnTDCShift[i] = stof(values[i]);
+		}
+		catch (...) {
+			return false;
+		}
+		return true;
+	}
+
+	if (values.size() != 1) return false;
+	const string& value = values[0];
+	if (key == "diamondChannel") {
+		try {
+			size_t pos;
+			s.diamondChannel = stoi(value, &pos);
+			return pos == value.size() && s.diamondChannel >= -1 && s.diamondChannel < 4;
+		}
+		catch (...) {
+			return false;
+		}
+	}
+	else if (key == "frontEcalFile") s.frontEcalFile = value;
+	else if (key == "backEcalFile") s.backEcalFile = value;
+	else if (key == "deltaEcalFile") s.deltaEcalFile = value;
+	else if (key == "frontTimecalFile") s.frontTimecalFile = value;
+	else if (key == "backTimecalFile") s.backTimecalFile = value;
+	else if (key == "deltaTimecalFile") s.deltaTimecalFile = value;
+	else if (key == "diamondEcalFile") s.diamondEcalFile = value;
+	else if (key == "PIDDir") s.PIDDir = value;
+	else if (key == "pidCache") s.pidCache = value;
+	else return false;
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CalibrationDB::CalibrationDB(SortConfig& config) {
+	calDir = config.GetCalDir();
+	tables = config.GetCalTables();
+
+	// Defaults for every run
+	CalibrationSet::Settings defaults;
+	defaults.frontEcalFile = config.GetFrontEcalFile();
+	defaults.backEcalFile = config.GetBackEcalFile();
+	defaults.deltaEcalFile = config.GetDeltaEcalFile();
+	defaults.frontTimecalFile = config.GetFrontTimecalFile();
+	defaults.backTimecalFile = config.GetBackTimecalFile();
+	defaults.deltaTimecalFile = config.GetDeltaTimecalFile();
+	defaults.diamondEcalFile = config.GetDiamondEcalFile();
+	defaults.PIDDir = config.GetPIDDir();
+	defaults.pidCache = config.GetPIDCache();
+	defaults.diamondChannel = -1;
+	defaults.tnTDCShift.assign(CalibrationSet::NTNTDC, 0.);
+
+	// Settings of each database entry, applied in file order to the runs it covers
+	struct Entry {
+		int first, last;
+		string key;
+		vector<string> values;
+	};
+	vector<Entry> entries;
+
+	string file = config.GetCalDBFile();
+	if (file != "none") {
+		ifstream in(file);
+		if (in.fail()) throw invalid_argument(string(BOLDRED) + string("Calibration database ") + file + string(" does not exist or failed to open") + string(RESET));
+
+		string line;
+		int lineNum = 0;
+		while (getline(in, line)) {
+			lineNum++;
+			size_t comment = line.find('#');
+			if (comment != string::npos) line.erase(comment);
+
+			// runs key values
+			istringstream ss(line);
+			string runs, value;
+			Entry entry;
+			if (!(ss >> runs)) continue;
+			string where = string(" on line ") + to_string(lineNum) + string(" of ") + file;
+			if (!(ss >> entry.key)) throw invalid_argument(string(BOLDRED) + string("Invalid calibration database entry") + where + string(RESET));
+			while (ss >> value) entry.values.push_back(value);
+			if (!ParseRuns(runs, entry.first, entry.last))
+				throw invalid_argument(string(BOLDRED) + string("Invalid run interval ") + runs + where + string(RESET));
+			if (!entries.empty() && entry.first < entries.back().first)
+				throw invalid_argument(string(BOLDRED) + string("Calibration database entries must be in order of first run") + where + string(RESET));
+
+			// Check the values now, so a bad entry is found before any run is sorted
+			CalibrationSet::Settings check = defaults;
+			if (!Apply(entry.key, entry.values, check))
+				throw invalid_argument(string(BOLDRED) + string("Unknown key or invalid value for ") + entry.key + where + string(RESET));
+
+			entries.push_back(entry);
+		}
+	}
+
+	// Split the run numbers at every interval boundary. Runs below 0 and runs
+	// no entry covers get an interval of their own, which Slot refuses
+	vector<int> bounds = {INT_MIN, 0};
+	for (const Entry& entry : entries) {
+		bounds.push_back(entry.first);
+		if (entry.last != INT_MAX) bounds.push_back(entry.last + 1);
+	}
+	sort(bounds.begin(), bounds.end());
+	bounds.erase(unique(bounds.begin(), bounds.end()), bounds.end());
+
+	for (int run : bounds) {
+		CalibrationSet::Settings s = defaults;
+		bool known = run >= 0 && file == "none"; // without a database sort.config covers every run
+		for (const Entry& entry : entries) {
+			if (run < entry.first || run > entry.last) continue;
+			Apply(entry.key, entry.values, s);
+			known = true;
+		}
+
+		// Intervals with the same settings share one set
+		size_t k = find(settings.begin(), settings.end(), s) - settings.begin();
+		if (k == settings.size()) settings.push_back(s);
+		if (!slot.empty() && slot.back() == k && covered.back() == known) continue;
+		firstRun.push_back(run);
+		slot.push_back(k);
+		covered.push_back(known);
+	}
+	sets.resize(settings.size());
+
+	// A gate cache file holds the gates of one PID directory
+	for (size_t i = 0; i < settings.size(); i++)
+		for (size_t j = 0; j < i; j++)
+			if (settings[i].pidCache != "none" && settings[i].pidCache == settings[j].pidCache && settings[i].PIDDir != settings[j].PIDDir)
+				throw invalid_argument(string(BOLDRED) + string("PID gate cache ") + settings[i].pidCache + string(" is used for both ") + settings[j].PIDDir + string(" and ") + settings[i].PIDDir + string(", give each PIDDir its own pidCache") + string(RESET));
+
+	if (file != "none") cout << "Calibration database " << file << ": " << settings.size() << " calibration set(s) over " << firstRun.size() << " run interval(s)" << endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t CalibrationDB::Slot(int run) const {
+	size_t i = upper_bound(firstRun.begin(), firstRun.end(), run) - firstRun.begin() - 1;
+	if (run < 0) throw invalid_argument(string(BOLDRED) + string("Invalid run number ") + to_string(run) + string(", no calibrations can be chosen for it") + string(RESET));
+	if (!covered[i]) throw invalid_argument(string(BOLDRED) + string("Run ") + to_string(run) + string(" is not covered by any entry of the calibration database") + string(RESET));
+	return slot[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+shared_ptr<const CalibrationSet> CalibrationDB::Get(int run) const {
+	size_t k = Slot(run);
+	lock_guard<mutex> lock(setsMutex);
+	if (!sets[k]) sets[k] = make_shared<const CalibrationSet>(settings[k], calDir, tables);
+	return sets[k];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CalibrationDB::Preload(const vector<int>& runs) const {
+	vector<bool> loaded(settings.size(), false);
+	for (int run : runs) {
+		size_t k = Slot(run);
+		if (loaded[k]) continue;
+		Get(run);
+		loaded[k] = true;
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,119 @@
+/**
+ * This header file contains the CalibrationDB class, the run-dependent
+ * calibrations of a job, and CalibrationSet, the calibrations of one epoch.
+ *
+ * A set holds everything that changes from one calibration epoch to the next:
+ * the Si energy and time calibrations, the diamond calibration and the diamond
+ * channel to use, the TexNeut TDC shifts and the PID banana gates. The values
+ * in sort.config are the defaults for every run, and the calibration database
+ * file (normally config/calibrations.config, see the format there) overrides
+ * them for intervals of run numbers. The run numbers are split at every
+ * interval boundary, and each distinct combination of settings is loaded once,
+ * the first time a run needs it, then kept for the rest of the job. A task
+ * asks for the set of a run when it moves on to that run and holds on to it,
+ * so a whole campaign can be sorted in one job.
+ */
+
+#ifndef CalibrationDB_H
+#define CalibrationDB_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "calibrate.h"
+#include "GateCache.h"
+#include "pid.h"
+#include "SortConfig.h"
+
+class CalibrationSet {
+
+public:
+	// Everything a set is loaded from, as given in sort.config and the
+	// database file
+	struct Settings {
+		std::string frontEcalFile, backEcalFile, deltaEcalFile;
+		std::string frontTimecalFile, backTimecalFile, deltaTimecalFile;
+		std::string diamondEcalFile;
+		std::string PIDDir, pidCache;
+		int diamondChannel;            // -1 if the diamond is not calibrated
+		std::vector<float> tnTDCShift; // subtracted from TexNeut TDC channels 4-15
+
+		bool operator==(const Settings& other) const;
+	};
+
+	CalibrationSet(const Settings& settings, const std::string& calDir, bool tables);
+	~CalibrationSet();
+	CalibrationSet(const CalibrationSet&) = delete;
+	CalibrationSet& operator=(const CalibrationSet&) = delete;
+
+	// Getters
+	const calibrate* GetFrontEcal() const { return FrontEcal; }
+	const calibrate* GetBackEcal() const { return BackEcal; }
+	const calibrate* GetDeltaEcal() const { return DeltaEcal; }
+	const calibrate* GetFrontTimecal() const { return FrontTimecal; }
+	const calibrate* GetBackTimecal() const { return BackTimecal; }
+	const calibrate* GetDeltaTimecal() const { return DeltaTimecal; }
+	const calibrate* GetDiamondEcal() const { return DiamondEcal; }
+	int GetDiamondChannel() const { return diamondChannel; }
+	const float* GetTNTDCShift() const { return tnTDCShift.data(); }
+	const pid* GetPid(int quad) const { return Pid[quad]; }
+
+	static constexpr int NTNTDC = 12; // TexNeut TDC channels
+
+private:
+	calibrate* FrontEcal;
+	calibrate* BackEcal;
+	calibrate* DeltaEcal;
+	calibrate* FrontTimecal;
+	calibrate* BackTimecal;
+	calibrate* DeltaTimecal;
+	calibrate* DiamondEcal;
+	int diamondChannel;
+	std::vector<float> tnTDCShift;
+
+	GateCache* gates;  // mapped banana gates, nullptr if the cache is off
+	pid* Pid[4];       // banana gates for each quadrant
+
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class CalibrationDB {
+
+public:
+	// Reads the database file given by calDBFile, or uses the sort.config
+	// values for every run if it is "none"
+	CalibrationDB(SortConfig& config);
+	CalibrationDB(const CalibrationDB&) = delete;
+	CalibrationDB& operator=(const CalibrationDB&) = delete;
+
+	// Calibrations of a run, loaded on first use. Thread safe, the set stays
+	// valid for as long as the caller holds it. Throws for a negative run or
+	// one that no database entry covers
+	std::shared_ptr<const CalibrationSet> Get(int run) const;
+
+	// Load the sets of the given runs now, so that a missing or bad file is
+	// reported before sorting starts rather than by a worker
+	void Preload(const std::vector<int>& runs) const;
+
+private:
+	// Runs from firstRun up to the next interval use settings[slot]
+	std::vector<int> firstRun;
+	std::vector<size_t> slot;
+	std::vector<bool> covered; // false if no database entry covers the interval
+
+	// One entry per distinct combination of settings
+	std::vector<CalibrationSet::Settings> settings;
+	mutable std::vector<std::shared_ptr<const CalibrationSet>> sets;
+	mutable std::mutex setsMutex;
+
+	std::string calDir;
+	bool tables;
+
+	size_t Slot(int run) const;
+
+};
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * This implementation file contains the ChannelMap class, which maps HINP
+ * (board, chan) to the face, quadrant and strip of the silicon telescopes.
+ * See ChannelMap.h and config/channelmap.config.
+ */
+
+#include "ChannelMap.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#include <stuffing.hpp>
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Read "first-last" or a single number. last may be below first.
+static bool ParseRange(const string& s, int& first, int& last) {
+	try {
+		size_t dash = s.find('-');
+		first = stoi(s.substr(0, dash));
+		last = (dash == string::npos) ? first : stoi(s.substr(dash + 1));
+	}
+	catch (...) {
+		return false;
+	}
+	return first >= 0 && last >= 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ChannelMap::ChannelMap(const string& file) {
+	channels.assign((HINP_BOARD_COUNT + 1) * HINP_CHAN_COUNT, Channel{Unused, 0, 0, 0});
+
+	ifstream in(file);
+	if (in.fail()) throw invalid_argument(string(BOLDRED) + string("Channel map file ") + file + string(" does not exist or failed to open") + string(RESET));
+
+	vector<bool> used(NFaces * NQuads * NStrips, false); // strips already connected
+
+	string line;
+	int lineNum = 0;
+	while (getline(in, line)) {
+		lineNum++;
+		size_t comment = line.find('#');
+		if (comment != string::npos) line.erase(comment);
+
+		// board channels face quadrant strips
+		istringstream ss(line);
+		string boardToken, chanToken, faceToken, quadToken, stripToken, extra;
+		if (!(ss >> boardToken)) continue;
+		string where = string(" on line ") + to_string(lineNum) + string(" of ") + file;
+		if (!(ss >> chanToken >> faceToken >> quadToken >> stripToken) || (ss >> extra))
+			throw invalid_argument(string(BOLDRED) + string("Invalid channel map entry") + where + string(RESET));
+
+		int board, quad, chanFirst, chanLast, stripFirst, stripLast;
+		try {
+			board = stoi(boardToken);
+			quad = stoi(quadToken);
+		}
+		catch (...) {
+			throw invalid_argument(string(BOLDRED) + string("Invalid channel map entry") + where + string(RESET));
+		}
+		if (!ParseRange(chanToken, chanFirst, chanLast) || !ParseRange(stripToken, stripFirst, stripLast) || chanLast < chanFirst)
+			throw invalid_argument(string(BOLDRED) + string("Invalid channel or strip range") + where + string(RESET));
+
+		Face face;
+		if (faceToken == "Front") face = Front;
+		else if (faceToken == "Back") face = Back;
+		else if (faceToken == "Delta") face = Delta;
+		else throw invalid_argument(string(BOLDRED) + string("Unknown face ") + faceToken + where + string(", must be Front, Back or Delta") + string(RESET));
+
+		int nchans = chanLast - chanFirst + 1;
+		int step = (stripLast >= stripFirst) ? 1 : -1;
+		if (abs(stripLast - stripFirst) + 1 != nchans)
+			throw invalid_argument(string(BOLDRED) + string("Channel and strip ranges have different lengths") + where + string(RESET));
+		if (board < 1 || board > HINP_BOARD_COUNT || chanLast >= HINP_CHAN_COUNT || quad < 0 || quad >= NQuads || max(stripFirst, stripLast) >= NStrips)
+			throw invalid_argument(string(BOLDRED) + string("Board, channel, quadrant or strip out of range") + where + string(RESET));
+
+		for (int k = 0; k < nchans; k++) {
+			Channel& channel = channels[board * HINP_CHAN_COUNT + chanFirst + k];
+			if (channel.face != Unused)
+				throw invalid_argument(string(BOLDRED) + string("Board ") + to_string(board) + string(" channel ") + to_string(chanFirst + k) + string(" is mapped twice") + where + string(RESET));
+			int strip = stripFirst + step * k;
+			channel = Channel{face, (uint8_t)quad, (uint8_t)strip, (uint16_t)(quad * NStrips + strip)};
+			if (used[face * NQuads * NStrips + channel.index])
+				throw invalid_argument(string(BOLDRED) + faceToken + string(" strip ") + to_string(strip) + string(" of quadrant ") + to_string(quad) + string(" is connected twice") + where + string(RESET));
+			used[face * NQuads * NStrips + channel.index] = true;
+		}
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,46 @@
+/**
+ * This header file contains the ChannelMap class, which says what each HINP
+ * channel is connected to: the face of the silicon telescopes (Front, Back or
+ * Delta), the quadrant and the strip. It is read from the channel map file
+ * (normally config/channelmap.config, see the format there) and looked up by
+ * (board, chan) for every hit, so a different cabling or detector layout is a
+ * change to that file rather than to Gobbi.
+ */
+
+#ifndef ChannelMap_H
+#define ChannelMap_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Input.h"
+
+class ChannelMap {
+
+public:
+	enum Face : int8_t { Front, Back, Delta, NFaces, Unused = NFaces };
+
+	struct Channel {
+		int8_t face;    // Unused if nothing is connected
+		uint8_t quad;
+		uint8_t strip;
+		uint16_t index; // quad * NStrips + strip, the calibration entry and summary spectrum bin
+	};
+
+	ChannelMap(const std::string& file);
+
+	// Boards are 1 to HINP_BOARD_COUNT, a channel outside the map is an
+	// unpacking error
+	bool Contains(size_t board, size_t chan) const { return board <= HINP_BOARD_COUNT && chan < HINP_CHAN_COUNT; }
+	const Channel& Get(size_t board, size_t chan) const { return channels[board * HINP_CHAN_COUNT + chan]; }
+
+	static const int NQuads = 4;
+	static const int NStrips = 32;
+
+private:
+	std::vector<Channel> channels; // by board * HINP_CHAN_COUNT + chan
+
+};
+
+#endif
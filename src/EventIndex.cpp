@@ -0,0 +1,178 @@
+/**
+ * This implementation file contains the EventIndex class. An index file is a
+ * small header followed by fixed-size Record structs sorted by entry:
+ *
+ *   char     magic[4]   "GIDX"
+ *   uint32_t version
+ *   uint32_t recordSize sizeof(Record), checked when mapping
+ *   int32_t  run
+ *   uint64_t nrecords
+ *
+ * Files are written and read on the same machine, so records are stored in
+ * native byte order.
+ */
+
+#include "EventIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <stuffing.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+	const char Magic[4] = {'G', 'I', 'D', 'X'};
+	const uint32_t Version = 1;
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t recordSize;
+		int32_t run;
+		uint64_t nrecords;
+	};
+}
+
+static_assert(sizeof(EventIndex::Record) == 24, "EventIndex::Record layout changed, bump Version");
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventIndex::EventIndex(const string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) throw invalid_argument(string(BOLDRED) + string("Event index ") + path + string(" does not exist or failed to open") + string(RESET));
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header)) {
+		close(fd);
+		throw invalid_argument(string(BOLDRED) + string("Event index ") + path + string(" is too short") + string(RESET));
+	}
+	mapSize = st.st_size;
+	mapping = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		mapping = nullptr;
+		throw invalid_argument(string(BOLDRED) + string("Could not map event index ") + path + string(RESET));
+	}
+
+	const Header* header = (const Header*)mapping;
+	if (memcmp(header->magic, Magic, 4) != 0 || header->version != Version || header->recordSize != sizeof(Record)
+	    || mapSize != sizeof(Header) + header->nrecords * sizeof(Record)) {
+		munmap(mapping, mapSize);
+		mapping = nullptr;
+		throw invalid_argument(string(BOLDRED) + string("Event index ") + path + string(" is not a valid version ") + to_string(Version) + string(" index, rebuild it with writeIndex = true") + string(RESET));
+	}
+	run = header->run;
+	nrecords = header->nrecords;
+	records = (const Record*)((const char*)mapping + sizeof(Header));
+
+	// Selections walk the file front to back
+	madvise(mapping, mapSize, MADV_SEQUENTIAL);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventIndex::~EventIndex() {
+	if (mapping) munmap(mapping, mapSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+vector<long long> EventIndex::Select(uint32_t mask) const {
+	vector<long long> entries;
+	for (const Record& rec : *this)
+		if ((rec.tags & mask) == mask) entries.push_back(rec.entry);
+	return entries;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+uint32_t EventIndex::ParseTags(const string& list) {
+	uint32_t mask = 0;
+	stringstream ss(list);
+	string tag;
+	while (getline(ss, tag, ',')) {
+		tag.erase(remove(tag.begin(), tag.end(), ' '), tag.end());
+		if (tag.empty()) continue;
+		if (tag == "p") mask |= TagProton;
+		else if (tag == "d") mask |= TagH2;
+		else if (tag == "t") mask |= TagH3;
+		else if (tag == "3He") mask |= TagHe3;
+		else if (tag == "a") mask |= TagAlpha;
+		else if (tag == "6He") mask |= TagHe6;
+		else if (tag == "6Li") mask |= TagLi6;
+		else if (tag == "7Li") mask |= TagLi7;
+		else if (tag == "n") mask |= TagNeutron;
+		else throw invalid_argument(string(BOLDRED) + string("Unknown event index tag '") + tag + string("', use p, d, t, 3He, a, 6He, 6Li, 7Li or n") + string(RESET));
+	}
+	return mask;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+string EventIndex::FileName(int runnum) {
+	return "run-" + to_string(runnum) + ".index";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventIndex::Write(const string& path, int run, vector<Record>& records) {
+	sort(records.begin(), records.end(), [](const Record& a, const Record& b) { return a.entry < b.entry; });
+
+	// Write to a temporary file and rename, so a reader never maps a half-written index
+	string tmp = path + ".tmp";
+	ofstream file(tmp, ios::binary | ios::trunc);
+	if (file.fail()) throw invalid_argument(string(BOLDRED) + string("Could not create event index ") + tmp + string(RESET));
+
+	Header header;
+	memcpy(header.magic, Magic, 4);
+	header.version = Version;
+	header.recordSize = sizeof(Record);
+	header.run = run;
+	header.nrecords = records.size();
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)records.data(), records.size() * sizeof(Record));
+	file.close();
+	if (file.fail() || rename(tmp.c_str(), path.c_str()) != 0)
+		throw invalid_argument(string(BOLDRED) + string("Could not write event index ") + path + string(RESET));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventIndex::Builder::AddRun(int run) {
+	lock_guard<std::mutex> lock(mutex);
+	runs[run];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventIndex::Builder::Add(int run, vector<Record>& records) {
+	if (records.empty()) return;
+	lock_guard<std::mutex> lock(mutex);
+	vector<Record>& all = runs[run];
+	all.insert(all.end(), records.begin(), records.end());
+	records.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventIndex::Builder::WriteAll(const string& dir) {
+	lock_guard<std::mutex> lock(mutex);
+	for (auto& run : runs) {
+		string path = dir + FileName(run.first);
+		Write(path, run.first, run.second);
+		cout << "Event index for run " << run.first << ": " << run.second.size() << " events written to " << path << endl;
+	}
+	runs.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,91 @@
+/**
+ * This header file contains the EventIndex class, a per-run sidecar file that
+ * lists the interesting events of a run (entry number, TDC trigger pattern,
+ * telescope multiplicities and PID tags). It is written during a normal sort
+ * and memory-mapped when read back, so a later sort can visit only the
+ * entries that carry a given set of tags (e.g. p + alpha + n for corr_6Li)
+ * instead of streaming the whole run.
+ */
+
+#ifndef EventIndex_H
+#define EventIndex_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class EventIndex {
+
+public:
+	// PID tags, one bit per identified species plus one for neutrons
+	enum Tag : uint32_t {
+		TagProton  = 1u << 0,
+		TagH2      = 1u << 1,
+		TagH3      = 1u << 2,
+		TagHe3     = 1u << 3,
+		TagAlpha   = 1u << 4,
+		TagHe6     = 1u << 5,
+		TagLi6     = 1u << 6,
+		TagLi7     = 1u << 7,
+		TagNeutron = 1u << 8
+	};
+
+	// One event of the index, stored as is in the file
+	struct Record {
+		uint64_t entry;   // entry number in the run's input tree
+		uint32_t tags;    // OR of Tag bits
+		uint16_t trigger; // bit i set if TDC channel i has a hit
+		uint8_t mult[4];  // solutions with a PID in each telescope
+		uint8_t nneut;    // neutron multiplicity
+		uint8_t unused;
+	};
+
+	// Map the index file of a run, throws if it is missing or not a valid index
+	EventIndex(const std::string& path);
+	~EventIndex();
+	EventIndex(const EventIndex&) = delete;
+	EventIndex& operator=(const EventIndex&) = delete;
+
+	size_t GetNRecords() const { return nrecords; }
+	int GetRun() const { return run; }
+	const Record& operator[](size_t i) const { return records[i]; }
+	const Record* begin() const { return records; }
+	const Record* end() const { return records + nrecords; }
+
+	// Entries, in increasing order, whose tags contain every bit of mask
+	std::vector<long long> Select(uint32_t mask) const;
+
+	// Parse a comma-separated tag list such as "p,a,n" into a mask
+	static uint32_t ParseTags(const std::string&);
+
+	// Name of the index file for a run, e.g. run-614.index
+	static std::string FileName(int runnum);
+
+	// Write the records of a run, sorted by entry
+	static void Write(const std::string& path, int run, std::vector<Record>& records);
+
+	// Collects records from all tasks and writes one index file per run at the end
+	class Builder {
+	public:
+		// Register a run that is sorted, so it gets an index even with no tagged events
+		void AddRun(int run);
+		void Add(int run, std::vector<Record>& records);
+		void WriteAll(const std::string& dir);
+	private:
+		std::mutex mutex;
+		std::map<int, std::vector<Record>> runs;
+	};
+
+private:
+	void* mapping{nullptr};
+	size_t mapSize{0};
+	const Record* records{nullptr};
+	size_t nrecords{0};
+	int run{-1};
+
+};
+
+#endif
@@ -0,0 +1,244 @@
+/**
+ * This implementation file contains the GateCache class. A cache file is a
+ * header, one SetEntry per zline file, one Gate per banana gate and then the
+ * x and y coordinates of all vertices:
+ *
+ *   char     magic[4]   "GGAT"
+ *   uint32_t version
+ *   uint32_t nsets
+ *   uint32_t ngates
+ *   uint64_t npoints
+ *   uint64_t checksum   FNV-1a of everything after the header
+ *
+ * Each SetEntry records the modification time and size of the zline file it
+ * was built from, which is how a stale cache is detected. Files are written
+ * and read on the same machine, so everything is in native byte order.
+ */
+
+#include "GateCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+#include <stuffing.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ZApar.h"
+
+using namespace std;
+
+namespace {
+	const char Magic[4] = {'G', 'G', 'A', 'T'};
+	const uint32_t Version = 1;
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t nsets;
+		uint32_t ngates;
+		uint64_t npoints;
+		uint64_t checksum;
+	};
+
+	struct SetEntry {
+		char name[32];
+		int64_t mtime;      // of the zline file, in ns
+		int64_t size;       // of the zline file
+		uint32_t firstGate;
+		uint32_t ngates;
+	};
+}
+
+static_assert(sizeof(Header) == 32 && sizeof(SetEntry) == 56 && sizeof(GateCache::Gate) == 16, "GateCache layout changed, bump Version");
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+static uint64_t Checksum(const char* data, size_t size) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Modification time and size of a zline file, false if it can not be read
+static bool SourceStamp(const string& file, int64_t& mtime, int64_t& size) {
+	struct stat st;
+	if (stat(file.c_str(), &st) != 0) return false;
+	mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+	size = st.st_size;
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+GateCache::GateCache(const string& path, const string& dir, const vector<string>& names) {
+	if (Map(path, dir, names)) return;
+
+	cout << "Building PID gate cache " << path << endl;
+	Build(path, dir, names);
+	if (!Map(path, dir, names))
+		throw invalid_argument(string(BOLDRED) + string("Could not use PID gate cache ") + path + string(" after rebuilding it") + string(RESET));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+GateCache::~GateCache() {
+	Unmap();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void GateCache::Unmap() {
+	if (mapping) munmap(mapping, mapSize);
+	mapping = nullptr;
+	mapSize = 0;
+	setNames.clear();
+	setFirst.clear();
+	setCount.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Map the cache and check it against the zline files. Returns false, with
+// nothing mapped, if the cache is missing, invalid or stale.
+bool GateCache::Map(const string& path, const string& dir, const vector<string>& names) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header)) {
+		close(fd);
+		return false;
+	}
+	mapSize = st.st_size;
+	mapping = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		mapping = nullptr;
+		return false;
+	}
+
+	const char* base = (const char*)mapping;
+	const Header* header = (const Header*)base;
+	size_t expected = sizeof(Header) + header->nsets * sizeof(SetEntry) + header->ngates * sizeof(Gate) + 2 * header->npoints * sizeof(float);
+	if (memcmp(header->magic, Magic, 4) != 0 || header->version != Version || header->nsets != names.size() || mapSize != expected
+	    || Checksum(base + sizeof(Header), mapSize - sizeof(Header)) != header->checksum) {
+		if (memcmp(header->magic, Magic, 4) == 0) cout << "PID gate cache " << path << " is invalid or from another version" << endl;
+		Unmap();
+		return false;
+	}
+
+	const SetEntry* sets = (const SetEntry*)(base + sizeof(Header));
+	gates = (const Gate*)(sets + header->nsets);
+	x = (const float*)(gates + header->ngates);
+	y = x + header->npoints;
+
+	for (size_t i = 0; i < names.size(); i++) {
+		const SetEntry& set = sets[i];
+		int64_t mtime, size;
+		bool stale = strncmp(set.name, names[i].c_str(), sizeof(set.name)) != 0
+		             || (SourceStamp(dir + names[i] + ".zline", mtime, size) && (mtime != set.mtime || size != set.size));
+		bool corrupt = (uint64_t)set.firstGate + set.ngates > header->ngates;
+		for (uint32_t k = 0; k < set.ngates && !corrupt; k++) {
+			const Gate& gate = gates[set.firstGate + k];
+			corrupt = (uint64_t)gate.firstPoint + gate.npoints > header->npoints;
+		}
+		if (stale || corrupt) {
+			if (stale) cout << "PID gate cache " << path << " is out of date with " << names[i] << ".zline" << endl;
+			Unmap();
+			return false;
+		}
+		setNames.push_back(names[i]);
+		setFirst.push_back(set.firstGate);
+		setCount.push_back(set.ngates);
+	}
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const GateCache::Gate* GateCache::GetGates(const string& name, int& ngates) const {
+	for (size_t i = 0; i < setNames.size(); i++) {
+		if (setNames[i] != name) continue;
+		ngates = setCount[i];
+		return gates + setFirst[i];
+	}
+	ngates = 0;
+	return nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void GateCache::Build(const string& path, const string& dir, const vector<string>& names) {
+	vector<SetEntry> sets;
+	vector<Gate> gates;
+	vector<float> xs, ys;
+
+	for (const string& name : names) {
+		string file = dir + name + ".zline";
+		SetEntry set{};
+		if (name.size() >= sizeof(set.name))
+			throw invalid_argument(string(BOLDRED) + string("zline name ") + name + string(" is too long for the PID gate cache") + string(RESET));
+		memcpy(set.name, name.c_str(), name.size());
+		ifstream ifile(file);
+		if (!ifile.is_open() || !SourceStamp(file, set.mtime, set.size))
+			throw invalid_argument(string(BOLDRED) + string("Could not open zline file ") + file + string(RESET));
+
+		// Same parsing as the text path, through ZApar. Gates with fewer than 3
+		// points are kept as they are, like the text path does (they contain nothing)
+		int nlines = 0;
+		ifile >> nlines;
+		set.firstGate = gates.size();
+		for (int i = 0; i < nlines; i++) {
+			ZApar par(ifile);
+			if (ifile.fail())
+				throw invalid_argument(string(BOLDRED) + string("Invalid banana gate ") + to_string(i) + string(" in zline file ") + file + string(RESET));
+			gates.push_back({par.Z, par.A, (uint32_t)xs.size(), (uint32_t)par.n});
+			xs.insert(xs.end(), par.x, par.x + par.n);
+			ys.insert(ys.end(), par.y, par.y + par.n);
+		}
+		set.ngates = nlines;
+		sets.push_back(set);
+	}
+
+	// Everything after the header, in file order
+	string body;
+	body.append((const char*)sets.data(), sets.size() * sizeof(SetEntry));
+	body.append((const char*)gates.data(), gates.size() * sizeof(Gate));
+	body.append((const char*)xs.data(), xs.size() * sizeof(float));
+	body.append((const char*)ys.data(), ys.size() * sizeof(float));
+
+	Header header;
+	memcpy(header.magic, Magic, 4);
+	header.version = Version;
+	header.nsets = sets.size();
+	header.ngates = gates.size();
+	header.npoints = xs.size();
+	header.checksum = Checksum(body.data(), body.size());
+
+	// Write to a temporary file and rename, so a reader never maps a half-written
+	// cache. The pid keeps jobs rebuilding the same cache off each other's file
+	string tmp = path + ".tmp." + to_string(getpid());
+	ofstream file(tmp, ios::binary | ios::trunc);
+	if (file.fail()) throw invalid_argument(string(BOLDRED) + string("Could not create PID gate cache ") + tmp + string(RESET));
+	file.write((const char*)&header, sizeof(header));
+	file.write(body.data(), body.size());
+	file.close();
+	if (file.fail() || rename(tmp.c_str(), path.c_str()) != 0) {
+		remove(tmp.c_str());
+		throw invalid_argument(string(BOLDRED) + string("Could not write PID gate cache ") + path + string(RESET));
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,60 @@
+/**
+ * This header file contains the GateCache class, a compiled copy of the PID
+ * banana gates of every quadrant in one binary file. The file holds the
+ * polygons of all zline files back to back, with a version number and a
+ * checksum, and is memory-mapped when read, so startup does not parse the
+ * text files or allocate each polygon separately. The cache is rebuilt from
+ * the zline files automatically when it is missing, invalid or when any of
+ * them has changed since it was built.
+ */
+
+#ifndef GateCache_H
+#define GateCache_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GateCache {
+
+public:
+	// One banana gate, stored as is in the file
+	struct Gate {
+		int32_t Z;
+		int32_t A;
+		uint32_t firstPoint; // index of the first vertex in the x and y arrays
+		uint32_t npoints;
+	};
+
+	// Map the cache built from the zline files names (without .zline) in
+	// dir, rebuilding it first if needed. Throws if it still can not be used.
+	GateCache(const std::string& path, const std::string& dir, const std::vector<std::string>& names);
+	~GateCache();
+	GateCache(const GateCache&) = delete;
+	GateCache& operator=(const GateCache&) = delete;
+
+	// Gates of one zline file, in file order, or nullptr if it is not in the
+	// cache. The vertices of gate i are x[first..first+n) and y[first..first+n)
+	const Gate* GetGates(const std::string& name, int& ngates) const;
+	const float* GetX() const { return x; }
+	const float* GetY() const { return y; }
+
+	// Convert the zline files to a cache file
+	static void Build(const std::string& path, const std::string& dir, const std::vector<std::string>& names);
+
+private:
+	void* mapping = nullptr;
+	size_t mapSize = 0;
+	std::vector<std::string> setNames;
+	std::vector<uint32_t> setFirst, setCount;
+	const Gate* gates = nullptr;
+	const float* x = nullptr;
+	const float* y = nullptr;
+
+	bool Map(const std::string& path, const std::string& dir, const std::vector<std::string>& names);
+	void Unmap();
+
+};
+
+#endif
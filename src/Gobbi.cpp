@@ -18,53 +18,62 @@
 
 #include "constants.h"
 
+#include <algorithm>
+
 using namespace std;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-Gobbi::Gobbi(Input& in, histo& hist, SortConfig& config, int run, event& neut) : input(in.GetGobbi()), Histo(hist), input_qdc(in.GetQDC()),input_tdc(in.GetTDC()), texneut(neut) {
-  Targetdist = config.GetTargDist();//23.95;//23.95;//24.1;//23.5; //cm //TODO is this correct? Shoud target dist be taken from input?
-  TargetThickness = config.GetTargThick();;//3.2;//2.65; //mg/cm^2 for CD2 tar1 //TODO same as targ dist but for thickness
+Gobbi::Gobbi(Input& in, histo& hist, const AnalysisContext& context, int run, event& neut) : input(in.GetGobbi()), Histo(hist), input_qdc(in.GetQDC()),input_tdc(in.GetTDC()), texneut(neut) {
+  Targetdist = context.GetTargDist();//23.95;//23.95;//24.1;//23.5; //cm //TODO is this correct? Shoud target dist be taken from input?
+  TargetThickness = context.GetTargThick();;//3.2;//2.65; //mg/cm^2 for CD2 tar1 //TODO same as targ dist but for thickness
   //TargetThickness = 3.8; //mg/cm^2
 
   for (int id = 0; id < 4; id++) {
-    Silicon[id] = new silicon(TargetThickness, config);
-    Silicon[id]->init(id,config); //tells Silicon what position it is in
+    Silicon[id] = new silicon(TargetThickness, context.GetLosses(), &arena);
+    Silicon[id]->init(id, nullptr, context.GetLinearPid()); //tells Silicon what position it is in, the gates come with the run's calibrations
     Silicon[id]->SetTargetDistance(Targetdist);
   }
 
-  string calDir = config.GetCalDir();
-  FrontEcal = new calibrate(4, Histo.channum, calDir + config.GetFrontEcalFile(), 1, false);
-  BackEcal = new calibrate(4, Histo.channum, calDir + config.GetBackEcalFile(), 1, false);
-  DeltaEcal = new calibrate(4, Histo.channum, calDir + config.GetDeltaEcalFile(), 1, false);
-  FrontTimecal = new calibrate(4, Histo.channum, calDir + config.GetFrontTimecalFile(),1, false);
-  BackTimecal = new calibrate(4, Histo.channum, calDir + config.GetBackTimecalFile(),1, false);  
-  DeltaTimecal = new calibrate(4, Histo.channum, calDir + config.GetDeltaTimecalFile(),1, false);
-  
-  DiamondEcal = new calibrate(1, 4, calDir + config.GetDiamondEcalFile(),1, false);
+  // Calibrations are loaded in AnalysisContext and shared between tasks,
+  // SetRun picks the set of the run
+  Calibrations = context.GetCalibrations();
+  linearPid = context.GetLinearPid();
+  Channels = context.GetChannelMap();
+  calDither = context.GetCalDither();
   
+  // In raw mode the run is not known until the first event
+  runnum = -1;
+  if (run >= 0) SetRun(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Gobbi::SetRun(int run) {
   //Run number
   runnum = run;
   
-  //Choose diamond calibration channel
-  // channel 0 of cal file: Runs < 561, diamond cal with 0.6 attentuation factor
-  if (runnum < 561) diamond_calch = 0;
-  else if (runnum >= 561 && runnum > 606) diamond_calch = 1; // 0.4 attenuation factor, -10 V
-  else if (runnum >= 606 && runnum < 613) diamond_calch = 2; // 0.4 attenuation factor, -20 V
-  else if (runnum >= 613) diamond_calch = 3; // 04 attenuation factor, -30 V
-  else diamond_calch = -1;
-  
+  //Calibrations of the run, including the diamond calibration channel. Runs
+  //of one calibration epoch share a set, so nothing changes within an epoch
+  shared_ptr<const CalibrationSet> cal = Calibrations->Get(run);
+  if (cal == Calib) return;
+  Calib = cal;
+
+  FrontEcal = Calib->GetFrontEcal();
+  BackEcal = Calib->GetBackEcal();
+  DeltaEcal = Calib->GetDeltaEcal();
+  FrontTimecal = Calib->GetFrontTimecal();
+  BackTimecal = Calib->GetBackTimecal();
+  DeltaTimecal = Calib->GetDeltaTimecal();
+  DiamondEcal = Calib->GetDiamondEcal();
+  diamond_calch = Calib->GetDiamondChannel();
+  TN_TDCShift = Calib->GetTNTDCShift();
+  for (int id = 0; id < 4; id++) Silicon[id]->init(id, Calib->GetPid(id), linearPid);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 Gobbi::~Gobbi() {
-  delete FrontEcal;
-  delete BackEcal;
-  delete DeltaEcal;
-  delete FrontTimecal;
-  delete BackTimecal;
-  delete DeltaTimecal;
 	for (int i = 0; i < 4; i++) delete Silicon[i]; // might not need this, but will try
 }
 
@@ -80,11 +89,11 @@ bool Gobbi::analyze() {
 	diamond_Ecal.clear();
 
 	//Look at diamond detector
-	for (int i=0;i<input_qdc.chan.size();i++) {
+	for (int i=0;i<input_qdc.GetNHits();i++) {
 	
 		//Get calibrated diamond energies
 		diamond_Ecal.push_back(0);
-		if (diamond_calch > -1) diamond_Ecal[i] = (DiamondEcal->getEnergy(0, diamond_calch, input_qdc.qh[i]));
+		if (diamond_calch > -1) diamond_Ecal[i] = (Calibrate(DiamondEcal, 0, diamond_calch, input_qdc.qh[i]));
 	
 		if (input_qdc.chan[i] == 0) {
 			Histo.DiamondQDC0->Fill(input_qdc.qh[i]);
@@ -104,10 +113,9 @@ bool Gobbi::analyze() {
 		if (input_qdc.chan[i] == 1) Histo.DiamondQDC1_cal->Fill(diamond_Ecal[i]);
 	}
 	
-	//Shift the TexNeut gamma time peaks so that they align with TexNeut board 1
-	float TN_TDCShift[12] = {0,0.078,1.207,0.994,6.821,7.356,-0.867,
-													 -0.943,0.259,-0.141,0.697,-0.19500000};
-													 
+	//TN_TDCShift (from the run's calibrations) shifts the TexNeut gamma time
+	//peaks so that they align with TexNeut board 1
+	
 	//array of shifted values, only take first for now			 
 	float TN_TDC_shift[12] = {0,0,0,0,0,0,0,0,0,0,0,0};
 	
@@ -181,104 +189,143 @@ bool Gobbi::analyze() {
 
   // Reset the Silicon class
   //cout << "here pre Si reset" << endl;
+  arena.reset();
   for (int i = 0; i < 4; i++) Silicon[i]->reset();
 	//cout << "here post Si reset, have " << input.GetNhits() << " hits" << endl;
 	size_t nhits = input.GetNhits();
-  for (int i = 0; i < nhits; i++) {
-    //check if there is an array for determined chip# and chan#
-    if (input.GetBoard(i) > 12 || input.GetChan(i) >= Histo.channum)
-    {
-      cout << "Nhits " << input.GetNhits() << endl;
-      cout << "i " << i << endl;
-      cout << "Board " << input.GetBoard(i) << " and chan " << input.GetChan(i);
-      cout << " unpacked but not saved" << endl;
-      return true;
-    }
-	//cout << "here pre Si storing " << i << endl;
-    float Energy = 0;
-    float time = 0; //can be calibrated or shifted later
-		
-    //Use calibration to get Energy and fill elist class in silicon
-    if (input.GetBoard(i) == 1 || input.GetBoard(i) == 3 || input.GetBoard(i) == 5 || input.GetBoard(i) == 7)
-    {
-      int quad = (input.GetBoard(i) - 1)/2;
-      Energy = FrontEcal->getEnergy(quad, input.GetChan(i), input.GetE(i));
-      time = FrontTimecal->getTime(quad, input.GetChan(i), input.GetT(i));
 
-      Histo.sumFrontE_R->Fill(quad*Histo.channum + input.GetChan(i), input.GetE(i));
-      Histo.sumFrontTime_R->Fill(quad*Histo.channum + input.GetChan(i), input.GetT(i));
-      Histo.sumFrontE_cal->Fill(quad*Histo.channum + input.GetChan(i), Energy);
-      Histo.sumFrontTime_cal->Fill(quad*Histo.channum + input.GetChan(i), time);
-
-      Histo.FrontE_R[quad][input.GetChan(i)]->Fill(input.GetE(i));
-      Histo.FrontElow_R[quad][input.GetChan(i)]->Fill(input.GetELo(i));
-      Histo.FrontTime_R[quad][input.GetChan(i)]->Fill(input.GetT(i));
-      Histo.FrontE_cal[quad][input.GetChan(i)]->Fill(Energy);      
+  //group the hits by face, up to the first one outside the channel map
+  for (int f=0;f<=ChannelMap::NFaces;f++) faceHits[f].n = 0;
+  size_t nstored = 0;
+  for (; nstored < nhits; nstored++)
+  {
+    size_t board = input.GetBoard(nstored);
+    size_t chan = input.GetChan(nstored);
+    if (!Channels->Contains(board, chan)) break;
+    const ChannelMap::Channel & channel = Channels->Get(board, chan);
+    FaceHits & hits = faceHits[channel.face];
+    hits.quad[hits.n] = channel.quad;
+    hits.strip[hits.n] = channel.strip;
+    hits.index[hits.n] = channel.index;
+    hits.e[hits.n] = input.GetE(nstored);
+    hits.eLo[hits.n] = input.GetELo(nstored);
+    hits.t[hits.n] = input.GetT(nstored);
+    hits.n++;
+  }
 
-      //if (Energy > .5 && input.GetT(i) > 3420 && input.GetT(i) < 6380 && (quad != 1 || Energy > 1.8))
-      //need to set thresholds just above noise
-      //if (quad == 1 && (
+  //calibrate all the hits of each face in one pass
+  const calibrate * Ecal[ChannelMap::NFaces] = {FrontEcal, BackEcal, DeltaEcal};
+  const calibrate * Timecal[ChannelMap::NFaces] = {FrontTimecal, BackTimecal, DeltaTimecal};
+  for (int f=0;f<ChannelMap::NFaces;f++)
+  {
+    FaceHits & hits = faceHits[f];
+    Span<uint16_t> index(hits.index, hits.n);
+    if (calDither) for (size_t k=0;k<hits.n;k++) hits.fraction[k] = Ran.Rndm();
+    Ecal[f]->getEnergy(index, {hits.e, hits.n}, calDither ? hits.fraction : nullptr, hits.energy);
+    Timecal[f]->getTime(index, {hits.t, hits.n}, hits.time);
+  }
 
-      if (Energy > .5) //(quad != 1 || Energy > 2)
-      {
-          Silicon[quad]->Front.Add(input.GetChan(i), Energy, input.GetELo(i), input.GetE(i), time);
-          Silicon[quad]->multFront++;
-      }
+  //fill spectra and the elist classes in silicon
+  const FaceHits & front = faceHits[ChannelMap::Front];
+  for (size_t k=0;k<front.n;k++)
+  {
+    int quad = front.quad[k];
+    int chan = front.strip[k];
+    float Energy = front.energy[k];
+    float time = front.time[k]; //can be calibrated or shifted later
+
+    Histo.sumFrontE_R->Fill(front.index[k], front.e[k]);
+    Histo.sumFrontTime_R->Fill(front.index[k], front.t[k]);
+    Histo.sumFrontE_cal->Fill(front.index[k], Energy);
+    Histo.sumFrontTime_cal->Fill(front.index[k], time);
+
+    Histo.FrontE_R[quad][chan]->Fill(front.e[k]);
+    Histo.FrontElow_R[quad][chan]->Fill(front.eLo[k]);
+    Histo.FrontTime_R[quad][chan]->Fill(front.t[k]);
+    Histo.FrontE_cal[quad][chan]->Fill(Energy);
+
+    //if (Energy > .5 && front.t[k] > 3420 && front.t[k] < 6380 && (quad != 1 || Energy > 1.8))
+    //need to set thresholds just above noise
+    //if (quad == 1 && (
+
+    if (Energy > .5) //(quad != 1 || Energy > 2)
+    {
+        Silicon[quad]->Front.Add(chan, Energy, front.eLo[k], front.e[k], time);
+        Silicon[quad]->multFront++;
     }
-    if (input.GetBoard(i) == 2 || input.GetBoard(i) == 4 || input.GetBoard(i) == 6 || input.GetBoard(i) == 8)
+  }
+
+  const FaceHits & back = faceHits[ChannelMap::Back];
+  for (size_t k=0;k<back.n;k++)
+  {
+    int quad = back.quad[k];
+    int chan = back.strip[k];
+    float Energy = back.energy[k];
+    float time = back.time[k];
+
+    Histo.sumBackE_R->Fill(back.index[k], back.e[k]);
+    Histo.sumBackTime_R->Fill(back.index[k], back.t[k]);
+    Histo.sumBackE_cal->Fill(back.index[k], Energy);
+    Histo.sumBackTime_cal->Fill(back.index[k], time);
+
+    Histo.BackE_R[quad][chan]->Fill(back.e[k]);
+    Histo.BackElow_R[quad][chan]->Fill(back.eLo[k]);
+    Histo.BackTime_R[quad][chan]->Fill(back.t[k]);
+    Histo.BackE_cal[quad][chan]->Fill(Energy);
+
+    if (Energy > .5)
     {
-      int quad = (input.GetBoard(i)/2)-1;
-      Energy = BackEcal->getEnergy(quad, input.GetChan(i), input.GetE(i));
-      time = BackTimecal->getTime(quad, input.GetChan(i), input.GetT(i));
-
-      Histo.sumBackE_R->Fill(quad*Histo.channum + input.GetChan(i), input.GetE(i));
-      Histo.sumBackTime_R->Fill(quad*Histo.channum + input.GetChan(i), input.GetT(i));
-      Histo.sumBackE_cal->Fill(quad*Histo.channum + input.GetChan(i), Energy);
-      Histo.sumBackTime_cal->Fill(quad*Histo.channum + input.GetChan(i), time);
-
-      Histo.BackE_R[quad][input.GetChan(i)]->Fill(input.GetE(i));
-      Histo.BackElow_R[quad][input.GetChan(i)]->Fill(input.GetELo(i));
-      Histo.BackTime_R[quad][input.GetChan(i)]->Fill(input.GetT(i));
-      Histo.BackE_cal[quad][input.GetChan(i)]->Fill(Energy);  
-
-      if (Energy > .5)
-      {      
-          Silicon[quad]->Back.Add(input.GetChan(i), Energy, input.GetELo(i), input.GetE(i), time);
-          Silicon[quad]->multBack++;
-      }
+        Silicon[quad]->Back.Add(chan, Energy, back.eLo[k], back.e[k], time);
+        Silicon[quad]->multBack++;
     }
-    if (input.GetBoard(i) == 9 || input.GetBoard(i) == 10 || input.GetBoard(i) == 11 || input.GetBoard(i) == 12)
+  }
+
+  const FaceHits & delta = faceHits[ChannelMap::Delta];
+  for (size_t k=0;k<delta.n;k++)
+  {
+    int quad = delta.quad[k];
+    int chan = delta.strip[k];
+    float Energy = delta.energy[k];
+    float time = delta.time[k];
+
+    Histo.sumDeltaE_R->Fill(delta.index[k], delta.e[k]);
+    Histo.sumDeltaTime_R->Fill(delta.index[k], delta.t[k]);
+    Histo.sumDeltaE_cal->Fill(delta.index[k], Energy);
+    Histo.sumDeltaTime_cal->Fill(delta.index[k], time);
+
+    Histo.DeltaE_R[quad][chan]->Fill(delta.e[k]);
+    Histo.DeltaElow_R[quad][chan]->Fill(delta.eLo[k]);
+    Histo.DeltaTime_R[quad][chan]->Fill(delta.t[k]);
+    Histo.DeltaE_cal[quad][chan]->Fill(Energy);
+
+    //if(Energy > .2 && delta.t[k] > 1765 && delta.t[k] < 8600)
+    if(Energy > .2)
     {
-      int quad = (input.GetBoard(i)-9);
-      Energy = DeltaEcal->getEnergy(quad, input.GetChan(i), input.GetE(i));
-      time = DeltaTimecal->getTime(quad, input.GetChan(i), input.GetT(i));
-
-      Histo.sumDeltaE_R->Fill(quad*Histo.channum + input.GetChan(i), input.GetE(i));
-      Histo.sumDeltaTime_R->Fill(quad*Histo.channum + input.GetChan(i), input.GetT(i));
-      Histo.sumDeltaE_cal->Fill(quad*Histo.channum + input.GetChan(i), Energy);
-      Histo.sumDeltaTime_cal->Fill(quad*Histo.channum + input.GetChan(i), time);
-
-      Histo.DeltaE_R[quad][input.GetChan(i)]->Fill(input.GetE(i));
-      Histo.DeltaElow_R[quad][input.GetChan(i)]->Fill(input.GetELo(i));
-      Histo.DeltaTime_R[quad][input.GetChan(i)]->Fill(input.GetT(i));
-      Histo.DeltaE_cal[quad][input.GetChan(i)]->Fill(Energy);  
-
-      //if(Energy > .2 && input.GetT(i) > 1765 && input.GetT(i) < 8600)
-      if(Energy > .2)
-      {
-        //if (quad == 0 && input.GetChan(i) == 0) cout << "EE " << Energy << endl;
-        
-        Silicon[quad]->Delta.Add(input.GetChan(i), Energy, input.GetELo(i), input.GetE(i), time);
-        Silicon[quad]->multDelta++;
-      }
+      //if (quad == 0 && chan == 0) cout << "EE " << Energy << endl;
+
+      Silicon[quad]->Delta.Add(chan, Energy, delta.eLo[k], delta.e[k], time);
+      Silicon[quad]->multDelta++;
     }
   }
+
+  if (nstored < nhits)
+  {
+    cout << "Nhits " << input.GetNhits() << endl;
+    cout << "i " << nstored << endl;
+    cout << "Board " << input.GetBoard(nstored) << " and chan " << input.GetChan(nstored);
+    cout << " unpacked but not saved" << endl;
+    return true;
+  }
   //data is unpacked and stored into Silicon class at this point
 
 	//cout << "here post Si storing" << endl;
-  //This is the spot if we run Silicon->Neighbours()
+  //put the strips of each face in energy order, then 
+  //this is the spot if we run Silicon->Neighbours()
   for (int id=0;id<4;id++) 
   {
+    Silicon[id]->Front.Sort();
+    Silicon[id]->Back.Sort();
+    Silicon[id]->Delta.Sort();
     Silicon[id]->Front.Neighbours(id);
     Silicon[id]->Back.Neighbours(id);
     Silicon[id]->Delta.Neighbours(id);
@@ -355,7 +402,7 @@ bool Gobbi::analyze() {
       //cout << "E " << Silicon[id]->Solution[isol].energy << "  dE " << Silicon[id]->Solution[isol].denergy << endl;
       
       //Fill QDC vs Gobbi Esum plots
-			for (int i=0;i<input_qdc.chan.size();i++) {
+			for (int i=0;i<input_qdc.GetNHits();i++) {
       	if (input_qdc.chan[i] == 0) {
       		Histo.Diamond_vs_GobbiEsum[id]->Fill(Silicon[id]->Solution[isol].energy + Silicon[id]->Solution[isol].denergy,input_qdc.qh[i]);
       		Histo.Diamond_vs_GobbiEsum_cal[id]->Fill(Silicon[id]->Solution[isol].energy + Silicon[id]->Solution[isol].denergy,diamond_Ecal[i]);
@@ -451,6 +498,17 @@ bool Gobbi::analyze() {
     Pidmulti += Silicon[id]->getPID();
   }
 
+  //continuous PID value, for setting pidDeltaThick and pidCutWidth
+  for (int id=0;id<4;id++)
+  {
+    if (!Silicon[id]->LinPid) continue;
+    for (int isol=0; isol<Silicon[id]->Nsolution; isol++)
+    {
+      Histo.PIDlin[id]->Fill(Silicon[id]->Solution[isol].pidValue);
+      Histo.PIDlin_E[id]->Fill(Silicon[id]->Solution[isol].energy, Silicon[id]->Solution[isol].pidValue);
+    }
+  }
+
   //hitmaps and other plots based on Pid
   for (int id=0;id<4;id++) 
   {
@@ -473,8 +531,8 @@ bool Gobbi::analyze() {
       }
       
       //Gated on QDC energy
-      if (input_qdc.chan.size() > 0) {
-      	for (int i=0;i<input_qdc.chan.size();i++) {
+      if (input_qdc.GetNHits() > 0) {
+      	for (int i=0;i<input_qdc.GetNHits();i++) {
       		if (input_qdc.chan[i] == 0 && input_qdc.qh[i] < 2000) {
       		  Histo.xyhitmap_DiamondELlow->Fill(xpos,ypos);
       		}
@@ -532,10 +590,23 @@ bool Gobbi::analyze() {
   }
 
   //calc sumEnergy,then account for Eloss in target, then set Ekin and momentum of solutions
-  //Eloss files are loaded in silicon
+  //the solutions of all four telescopes are corrected in one batch
+  float elossE[4*silicon::MaxSolution], elossThick[4*silicon::MaxSolution];
+  float elossA[4*silicon::MaxSolution], elossEin[4*silicon::MaxSolution];
+  int elossZ[4*silicon::MaxSolution];
+  int nEloss[4];
+  int nsol = 0;
   for (int id=0;id<4;id++) 
   {
-    Silicon[id]->calcEloss();
+    nEloss[id] = Silicon[id]->fillEloss(elossE+nsol,elossThick+nsol,elossZ+nsol,elossA+nsol);
+    nsol += nEloss[id];
+  }
+  Silicon[0]->losses->getEin(nsol,elossE,elossThick,elossZ,elossA,elossEin);
+  nsol = 0;
+  for (int id=0;id<4;id++) 
+  {
+    Silicon[id]->applyEloss(elossEin+nsol);
+    nsol += nEloss[id];
   }
 
 
@@ -654,6 +725,38 @@ bool Gobbi::analyze() {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+EventIndex::Record Gobbi::MakeIndexRecord(long long entry) const
+{
+  EventIndex::Record rec = {};
+  rec.entry = entry;
+  rec.nneut = min(num_neut, 255);
+  if (num_neut > 0) rec.tags |= EventIndex::TagNeutron;
+
+  for (int i=0;i<TDC_CHAN_COUNT;i++)
+    if (input_tdc.Nhits[i] > 0) rec.trigger |= (1 << i);
+
+  for (int id=0;id<4;id++)
+  {
+    for (int isol=0; isol<Silicon[id]->Nsolution; isol++)
+    {
+      const solution& sol = Silicon[id]->Solution[isol];
+      if (!sol.ipid) continue;
+      if (rec.mult[id] < 255) rec.mult[id]++;
+      if (sol.iZ == 1 && sol.iA == 1) rec.tags |= EventIndex::TagProton;
+      if (sol.iZ == 1 && sol.iA == 2) rec.tags |= EventIndex::TagH2;
+      if (sol.iZ == 1 && sol.iA == 3) rec.tags |= EventIndex::TagH3;
+      if (sol.iZ == 2 && sol.iA == 3) rec.tags |= EventIndex::TagHe3;
+      if (sol.iZ == 2 && sol.iA == 4) rec.tags |= EventIndex::TagAlpha;
+      if (sol.iZ == 2 && sol.iA == 6) rec.tags |= EventIndex::TagHe6;
+      if (sol.iZ == 3 && sol.iA == 6) rec.tags |= EventIndex::TagLi6;
+      if (sol.iZ == 3 && sol.iA == 7) rec.tags |= EventIndex::TagLi7;
+    }
+  }
+  return rec;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 int Gobbi::match()
 {
   //match dE, Efront, Eback as one hit
@@ -670,6 +773,14 @@ float Gobbi::getEnergy(int board, int chan, int Ehigh)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+float Gobbi::Calibrate(const calibrate* cal, int itele, int istrip, size_t raw)
+{
+  if (calDither) return cal->getEnergy(itele, istrip, (int)raw, (float)Ran.Rndm());
+  return cal->getEnergy(itele, istrip, (float)raw);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void Gobbi::TransferNeutSols()
 {
   neutSol.reset();
@@ -910,7 +1021,7 @@ void Gobbi::corr_6Li()
 			Histo.Erel_6Li_da_vsDiamond_tgate_orA->Fill(Erel_6Li,input_qdc.qh[0]);
 		}
 
-		for (int i=0;i<input_qdc.chan.size();i++) {
+		for (int i=0;i<input_qdc.GetNHits();i++) {
 			if (input_qdc.chan[i] == 0) {
 				//Sum energies
 				float partsum = Correl.frag[0]->energy+Correl.frag[0]->denergy + Correl.frag[1]->energy+Correl.frag[1]->denergy;
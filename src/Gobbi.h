@@ -17,8 +17,12 @@
  * at TAMU Cyclotron Institute
  */
 
+#include "AnalysisContext.h"
 #include "calibrate.h"
+#include "CalibrationDB.h"
+#include "ChannelMap.h"
 #include "correl2.h"
+#include "EventIndex.h"
 #include "histo.h"
 #include "Input.h"
 #include "silicon.h"
@@ -27,18 +31,28 @@
 
 #include <eventclass.hpp> // TNLIB TexNeut event class
 
+#include <TRandom3.h>
+
 #include <iostream>
+#include <memory>
 #include <string>
 
 class Gobbi {
 
 public:
-	Gobbi(Input& in, histo& hist, SortConfig& config, int run, event& neut);
+	Gobbi(Input& in, histo& hist, const AnalysisContext& context, int run, event& neut);
 	~Gobbi();
 
+	// Switch to the calibrations of a run (see CalibrationDB) when the
+	// scheduler moves this object on to events from a different run
+	void SetRun(int run);
+
 	bool analyze();
 	int match();
 
+	// Summarise the event just analyzed for the run's event index
+	EventIndex::Record MakeIndexRecord(long long entry) const;
+
 	float getEnergy(int board, int chan, int Ehigh);
 
 	void corr_4He();
@@ -60,15 +74,46 @@ public:
 
 	histo& Histo;
 	event& texneut;
-	calibrate* FrontEcal;
-	calibrate* BackEcal;
-	calibrate* DeltaEcal;
-	calibrate* FrontTimecal;
-	calibrate* BackTimecal;
-	calibrate* DeltaTimecal;
-
-	calibrate* DiamondEcal;
-
+	// Calibration set of the current run, shared between tasks. The pointers
+	// below point into it and are swapped by SetRun
+	const CalibrationDB* Calibrations;
+	std::shared_ptr<const CalibrationSet> Calib;
+	const LinearPID* linearPid;
+	const calibrate* FrontEcal;
+	const calibrate* BackEcal;
+	const calibrate* DeltaEcal;
+	const calibrate* FrontTimecal;
+	const calibrate* BackTimecal;
+	const calibrate* DeltaTimecal;
+
+	const calibrate* DiamondEcal;
+	bool calDither;  // add a random fraction of a channel before calibrating
+	TRandom3 Ran;    // dither generator, seeded per task by the caller
+
+	// Calibrated energy of a raw value, dithered if enabled
+	float Calibrate(const calibrate* cal, int itele, int istrip, size_t raw);
+
+	// What each HINP channel is connected to, owned by AnalysisContext
+	const ChannelMap* Channels;
+
+	// Hits of the current event grouped by face, so that each face is
+	// calibrated in one pass. Hits of unused channels go to the extra last
+	// entry, which is never read.
+	struct FaceHits {
+		size_t n;
+		uint16_t quad[HINP_NCOLUMNS];
+		uint16_t strip[HINP_NCOLUMNS];
+		uint16_t index[HINP_NCOLUMNS]; // quad * channum + strip
+		uint32_t e[HINP_NCOLUMNS];
+		uint32_t eLo[HINP_NCOLUMNS];
+		uint32_t t[HINP_NCOLUMNS];
+		float fraction[HINP_NCOLUMNS]; // dither
+		float energy[HINP_NCOLUMNS];
+		float time[HINP_NCOLUMNS];
+	};
+	FaceHits faceHits[ChannelMap::NFaces + 1];
+
+	SolutionArena arena; // solutions of the current event
 	silicon* Silicon[4];
 	solution neutSol;
 	correl2 Correl;
@@ -85,6 +130,7 @@ public:
 	
 	int runnum;
 	int diamond_calch = -1;
+	const float* TN_TDCShift; // subtracted from TexNeut TDC channels 4-15
 	
 	//TexNeut TDC gates
 	float TN_TDClow = -147;
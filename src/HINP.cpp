@@ -28,24 +28,27 @@ HINP::HINP()
 0 a2 d    just some junk included in the buffer?
 */
 
-bool HINP::unpackSi_HINP4(unsigned short *&point)
+//end is one past the last word of the event, the packet must fit before it
+bool HINP::unpackSi_HINP4(unsigned short *&point, const unsigned short *end)
 {
   //reset multiplicities at the start
   multEfront = 0;
   multEback = 0;
   multdE = 0;
 
+  if (point >= end) return false;
   unsigned short *endpos = point;
   unsigned short words = *point++;
   endpos += words;
 
-  unsigned short marker;
+  //the header (marker, NWords, NstripsRead and the 4 skipped words) must be in the packet
+  if (words < 8 || endpos >= end) return false;
 
-  marker = *point++;
+  unsigned short readMarker = *point++;
   
-  if (marker != 0x1ff0)
+  if (readMarker != marker)
   { 
-    cout << "Did not read the proper XLM marker. Was " << hex << marker << " expected 0x1ff3" << dec <<endl;
+    cout << "Did not read the proper XLM marker. Was " << hex << readMarker << " expected " << marker << dec <<endl;
     return false;
   }
   
@@ -88,6 +91,9 @@ bool HINP::unpackSi_HINP4(unsigned short *&point)
     return false;
   }
 
+  //the strips follow the 8 header words and must fit in the packet
+  if (8 + 4*NstripsRead > words) return false;
+
   point += 5;
     
   //cout << "NStrips " << NstripsRead <<  endl;
@@ -16,7 +16,11 @@ class HINP
   int NstripsRead;
   
   //max length of the packet. increase if event rate is high or coincidence is high
-  static const int maxlen = 162;
+  //(512 is the largest strip count unpackSi_HINP4 accepts as a good buffer)
+  static const int maxlen = 512;
+
+  //XLM marker expected at the start of the packet, depends on the motherboard
+  unsigned short marker = 0x1ff0;
   
   unsigned short board[maxlen];
   unsigned short chan[maxlen];
@@ -25,7 +29,7 @@ class HINP
   unsigned short low[maxlen];
   unsigned short time[maxlen];
 
-  bool unpackSi_HINP4(unsigned short *&point);
+  bool unpackSi_HINP4(unsigned short *&point, const unsigned short *end);
 
   int multEfront;
   int multEback;
@@ -0,0 +1,240 @@
+/**
+ * This implementation file contains the spectrum registry used by the histo
+ * class. See HistStore.h for an overview and config/spectra.config for the
+ * declaration format.
+ */
+
+#include "HistStore.h"
+
+#include <TDirectory.h>
+#include <TH1I.h>
+#include <TH2I.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fnmatch.h>
+
+#include <stuffing.hpp>
+
+using namespace std;
+
+namespace {
+
+	vector<HistStore::Spectrum> spectra;
+	unordered_map<string, size_t> ids; // name -> id
+	size_t blockSize = 0;              // bin contents of all spectra, in elements
+
+	// One block of bin contents per thread, kept until the end of the job.
+	// Blocks come from calloc, so pages of spectra that are never filled are
+	// never touched.
+	struct FreeDeleter {
+		void operator()(uint32_t* p) const { free(p); }
+	};
+	mutex blockMutex;
+	vector<unique_ptr<uint32_t[], FreeDeleter>> blocks;
+	thread_local uint32_t* threadBlock = nullptr;
+
+	// Filled by handles of disabled spectra, large enough for the bins and
+	// entries of an empty 2D spectrum
+	thread_local uint32_t scratch[5];
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Expand every {first-last} range in a name, e.g. FrontE_R{0-3}_{0-31}
+static void ExpandName(const string& pattern, vector<string>& names) {
+	size_t open = pattern.find('{');
+	if (open == string::npos) {
+		names.push_back(pattern);
+		return;
+	}
+	size_t close = pattern.find('}', open);
+	size_t dash = pattern.find('-', open);
+	if (close == string::npos || dash == string::npos || dash > close)
+		throw invalid_argument(string(BOLDRED) + string("Invalid range in spectrum name ") + pattern + string(RESET));
+	int first = stoi(pattern.substr(open + 1, dash - open - 1));
+	int last = stoi(pattern.substr(dash + 1, close - dash - 1));
+	for (int i = first; i <= last; i++)
+		ExpandName(pattern.substr(0, open) + to_string(i) + pattern.substr(close + 1), names);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+static bool IsNumber(const string& s) {
+	char* end = nullptr;
+	strtod(s.c_str(), &end);
+	return end != s.c_str() && *end == '\0';
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistStore::Load(const string& file, const vector<string>& disabled) {
+	ifstream in(file);
+	if (in.fail()) throw invalid_argument(string(BOLDRED) + string("Spectra file ") + file + string(" does not exist or failed to open") + string(RESET));
+
+	spectra.clear();
+	ids.clear();
+	blockSize = 0;
+
+	string line;
+	int lineNum = 0;
+	size_t ndisabled = 0;
+	unordered_set<string> declared; // names of all spectra, disabled or not
+	while (getline(in, line)) {
+		lineNum++;
+		size_t comment = line.find('#');
+		if (comment != string::npos) line.erase(comment);
+
+		istringstream ss(line);
+		vector<string> tokens;
+		string token;
+		while (ss >> token) tokens.push_back(token);
+		if (tokens.empty()) continue;
+
+		// dir name nbinsx xlow xup [nbinsy ylow yup] [option]
+		Spectrum s{};
+		size_t next = 5;
+		try {
+			if (tokens.size() < 5) throw 0;
+			s.dir = (tokens[0] == "/") ? "" : tokens[0];
+			s.nbinsx = stoi(tokens[2]);
+			s.xlow = stod(tokens[3]);
+			s.xup = stod(tokens[4]);
+			if (tokens.size() >= 8 && IsNumber(tokens[5])) {
+				s.nbinsy = stoi(tokens[5]);
+				s.ylow = stod(tokens[6]);
+				s.yup = stod(tokens[7]);
+				next = 8;
+			}
+			if (next < tokens.size()) s.option = tokens[next++];
+			if (next < tokens.size()) throw 0;
+			if (s.nbinsx <= 0 || s.nbinsy < 0 || !(s.xup > s.xlow) || (s.nbinsy > 0 && !(s.yup > s.ylow))) throw 0;
+		}
+		catch (...) {
+			throw invalid_argument(string(BOLDRED) + string("Invalid spectrum declaration on line ") + to_string(lineNum) + string(" of ") + file + string(RESET));
+		}
+		s.nbins = (s.nbinsy > 0) ? size_t(s.nbinsx + 2) * size_t(s.nbinsy + 2) : size_t(s.nbinsx + 2);
+
+		vector<string> names;
+		ExpandName(tokens[1], names);
+		for (const string& name : names) {
+			// The analysis code looks spectra up by name alone, so a name may only
+			// be used once, in whichever directory, even if a copy is disabled
+			if (!declared.insert(name).second)
+				throw invalid_argument(string(BOLDRED) + string("Spectrum ") + name + string(" is declared twice in ") + file + string(", names must be unique across directories") + string(RESET));
+
+			string path = s.dir.empty() ? name : s.dir + "/" + name;
+			bool skip = false;
+			for (const string& pattern : disabled)
+				if (fnmatch(pattern.c_str(), path.c_str(), 0) == 0) skip = true;
+			if (skip) {
+				ndisabled++;
+				continue;
+			}
+			s.name = name;
+			s.offset = blockSize;
+			blockSize += s.nbins + 1; // bins and entries
+			ids[name] = spectra.size();
+			spectra.push_back(s);
+		}
+	}
+
+	cout << "Spectra: " << spectra.size() << " declared, " << ndisabled << " disabled, "
+	     << blockSize * sizeof(uint32_t) / (1024 * 1024) << " MB per thread" << endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t HistStore::Find(const string& name, int dimension) {
+	auto it = ids.find(name);
+	if (it == ids.end()) return None;
+	if ((spectra[it->second].nbinsy > 0 ? 2 : 1) != dimension)
+		throw invalid_argument(string(BOLDRED) + string("Spectrum ") + name + string(" is not declared as ") + to_string(dimension) + string("D in the spectra file") + string(RESET));
+	return it->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const HistStore::Spectrum& HistStore::Get(size_t id) {
+	return spectra[id];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+uint32_t* HistStore::Counts(size_t id) {
+	if (id == None) return scratch;
+
+	// A thread keeps its block until the end of the job, so later tasks on
+	// the same thread keep adding to the same bins. Tasks nested on one thread
+	// (e.g. while it waits inside ROOT's task arena) only interleave, they
+	// never fill at the same time, so plain increments are safe.
+	if (!threadBlock) {
+		// At least one word, calloc(0) may return null when every spectrum is disabled
+		threadBlock = static_cast<uint32_t*>(calloc(max<size_t>(blockSize, 1), sizeof(uint32_t)));
+		if (!threadBlock) throw runtime_error("Failed to allocate spectrum storage");
+		lock_guard<mutex> lock(blockMutex);
+		blocks.emplace_back(threadBlock);
+	}
+	return threadBlock + spectra[id].offset;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Find or create a directory inside the output file
+static TDirectory* GetDirectory(TDirectory* file, const string& path) {
+	TDirectory* dir = file;
+	size_t start = 0;
+	while (start < path.size()) {
+		size_t end = path.find('/', start);
+		if (end == string::npos) end = path.size();
+		string name = path.substr(start, end - start);
+		TDirectory* sub = dir->GetDirectory(name.c_str());
+		if (!sub) sub = dir->mkdir(name.c_str(), name.c_str());
+		dir = sub;
+		start = end + 1;
+	}
+	return dir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistStore::Write(TDirectory* file) {
+	lock_guard<mutex> lock(blockMutex);
+
+	vector<unsigned long long> total;
+	for (const Spectrum& s : spectra) {
+
+		// Add up the threads
+		total.assign(s.nbins + 1, 0);
+		for (const auto& block : blocks) {
+			const uint32_t* counts = block.get() + s.offset;
+			for (size_t bin = 0; bin <= s.nbins; bin++) total[bin] += counts[bin];
+		}
+
+		TDirectory* dir = GetDirectory(file, s.dir);
+		unique_ptr<TH1> hist;
+		if (s.nbinsy > 0) hist.reset(new TH2I(s.name.c_str(), "", s.nbinsx, s.xlow, s.xup, s.nbinsy, s.ylow, s.yup));
+		else hist.reset(new TH1I(s.name.c_str(), "", s.nbinsx, s.xlow, s.xup));
+		hist->SetDirectory(nullptr);
+
+		for (size_t bin = 0; bin < s.nbins; bin++)
+			if (total[bin] > 0) hist->SetBinContent(bin, (double)min<unsigned long long>(total[bin], INT_MAX));
+		hist->SetEntries((double)total[s.nbins]);
+		if (!s.option.empty()) hist->SetOption(s.option.c_str());
+
+		dir->WriteTObject(hist.get());
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
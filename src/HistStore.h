@@ -0,0 +1,128 @@
+/**
+ * This header file contains the spectrum registry used by the histo class.
+ * Every spectrum is declared once in the spectra file (see
+ * config/spectra.config) with its directory, name, binning and draw option,
+ * and gets an integer id. The bin contents of all spectra are stored in one
+ * contiguous block of plain integers per thread, which lives for the whole
+ * job, so filling is a single increment with no locking and no ROOT objects
+ * per task. Once all workers are done, HistStore::Write adds up the blocks
+ * of every thread and writes a single TH1I/TH2I per spectrum to the output
+ * file.
+ *
+ * Spectra that are not declared, or that match one of the disableSpectra
+ * patterns, get no storage at all. Their handles fill a small per-thread
+ * scratch area instead, so the analysis code does not need to check.
+ */
+
+#ifndef HistStore_H
+#define HistStore_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TDirectory;
+
+namespace HistStore {
+
+	// Id of a spectrum that is not declared or is disabled
+	const size_t None = size_t(-1);
+
+	struct Spectrum {
+		std::string dir;  // "" for the top of the output file, otherwise "a/b"
+		std::string name;
+		std::string option;
+		int nbinsx;
+		double xlow, xup;
+		int nbinsy;       // 0 for a 1D spectrum
+		double ylow, yup;
+		size_t nbins;     // including underflow and overflow bins
+		size_t offset;    // start of the bin contents in a thread's block
+	};
+
+	// Read the spectrum declarations. Spectra whose "dir/name" matches one of
+	// the shell-style patterns in disabled are skipped. Call once, before any
+	// histo object is made.
+	void Load(const std::string& file, const std::vector<std::string>& disabled);
+
+	// Id of a 1D or 2D spectrum by name (without its directory, names are
+	// unique across directories), or None. Throws if the spectrum is
+	// declared with the other dimension.
+	size_t Find(const std::string& name, int dimension);
+
+	const Spectrum& Get(size_t id);
+
+	// Bin contents of a spectrum for the calling thread. The element after
+	// the last bin counts the number of fills (ROOT's entries).
+	uint32_t* Counts(size_t id);
+
+	// Add up all threads and write the spectra to the file. Call once, after
+	// all workers have finished.
+	void Write(TDirectory* file);
+
+}
+
+// Handle of a 1D spectrum, filled like a TH1I with fixed binning. The bin
+// numbering, including the underflow and overflow bins, is the same as ROOT's.
+class FlatH1 {
+
+public:
+	explicit FlatH1(size_t id) : counts(HistStore::Counts(id)), nx(0), xmin(0), xmax(0) {
+		if (id == HistStore::None) return;
+		const HistStore::Spectrum& s = HistStore::Get(id);
+		nx = s.nbinsx;
+		xmin = s.xlow;
+		xmax = s.xup;
+	}
+
+	void Fill(double x) {
+		counts[FindBin(x, nx, xmin, xmax)]++;
+		counts[nx + 2]++;
+	}
+
+	// Same expression as TAxis::FindBin, so a value on a bin edge lands in
+	// the same bin as it would with TH1::Fill
+	static int FindBin(double x, int nbins, double low, double up) {
+		if (x < low) return 0;
+		if (!(x < up)) return nbins + 1;
+		return 1 + int(nbins * (x - low) / (up - low));
+	}
+
+private:
+	uint32_t* counts;
+	int nx; // 0 for a disabled spectrum, which then only uses bins 0 and 1
+	double xmin, xmax;
+
+};
+
+// Handle of a 2D spectrum, filled like a TH2I with fixed binning
+class FlatH2 {
+
+public:
+	explicit FlatH2(size_t id) : counts(HistStore::Counts(id)), nx(0), ny(0), xmin(0), xmax(0), ymin(0), ymax(0) {
+		if (id == HistStore::None) return;
+		const HistStore::Spectrum& s = HistStore::Get(id);
+		nx = s.nbinsx;
+		ny = s.nbinsy;
+		xmin = s.xlow;
+		xmax = s.xup;
+		ymin = s.ylow;
+		ymax = s.yup;
+	}
+
+	void Fill(double x, double y) {
+		int binx = FlatH1::FindBin(x, nx, xmin, xmax);
+		int biny = FlatH1::FindBin(y, ny, ymin, ymax);
+		counts[binx + (nx + 2) * biny]++;
+		counts[(nx + 2) * (ny + 2)]++;
+	}
+
+private:
+	uint32_t* counts;
+	int nx, ny;
+	double xmin, xmax, ymin, ymax;
+
+};
+
+#endif
@@ -0,0 +1,129 @@
+/* Compact, zero-suppressed intermediate event format, see HitList.h for the
+ * layout of the files.
+ */
+
+#include "HitList.h"
+
+#include <Compression.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TTreeReader.h>
+
+#include <exception>
+#include <memory>
+
+#include <stuffing.hpp>
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+string HitList::FileName(int runnum) {
+	return "run-" + to_string(runnum) + ".hits.root";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitList::Event::Branch(TTree* tree) {
+	tree->Branch("bad", &bad, "bad/b");
+
+	tree->Branch("nhinp", &nhinp, "nhinp/s");
+	tree->Branch("hinp_id", hinp_id, "hinp_id[nhinp]/s");
+	tree->Branch("hinp_e", hinp_e, "hinp_e[nhinp]/i");
+	tree->Branch("hinp_eLo", hinp_eLo, "hinp_eLo[nhinp]/i");
+	tree->Branch("hinp_t", hinp_t, "hinp_t[nhinp]/i");
+
+	tree->Branch("npsd", &npsd, "npsd/s");
+	tree->Branch("psd_id", psd_id, "psd_id[npsd]/s");
+	tree->Branch("psd_a", psd_a, "psd_a[npsd]/i");
+	tree->Branch("psd_b", psd_b, "psd_b[npsd]/i");
+	tree->Branch("psd_c", psd_c, "psd_c[npsd]/i");
+	tree->Branch("psd_t", psd_t, "psd_t[npsd]/i");
+
+	tree->Branch("nqdc", &nqdc, "nqdc/s");
+	tree->Branch("qdc_chan", qdc_chan, "qdc_chan[nqdc]/s");
+	tree->Branch("qdc_h", qdc_h, "qdc_h[nqdc]/i");
+	tree->Branch("qdc_l", qdc_l, "qdc_l[nqdc]/i");
+
+	tree->Branch("ntdc", &ntdc, "ntdc/s");
+	tree->Branch("tdc_id", tdc_id, "tdc_id[ntdc]/s");
+	tree->Branch("tdc_t", tdc_t, "tdc_t[ntdc]/D");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitList::Event::Fill(const Input& input, bool isBad) {
+	bad = isBad;
+
+	const Input::GobbiInput& gobbi = input.GetGobbi();
+	nhinp = gobbi.GetNhits();
+	for (size_t i = 0; i < nhinp; i++) {
+		hinp_id[i] = (gobbi.GetBoard(i) - 1) * HINP_CHAN_COUNT + gobbi.GetChan(i);
+		hinp_e[i] = gobbi.GetE(i);
+		hinp_eLo[i] = gobbi.GetELo(i);
+		hinp_t[i] = gobbi.GetT(i);
+	}
+
+	const Input::TexNeutInput& texneut = input.GetTexNeut();
+	npsd = texneut.GetNhits();
+	for (size_t i = 0; i < npsd; i++) {
+		psd_id[i] = (texneut.GetChip(i) - 1) * PSD_CHAN_COUNT + texneut.GetChan(i);
+		psd_a[i] = texneut.GetA(i);
+		psd_b[i] = texneut.GetB(i);
+		psd_c[i] = texneut.GetC(i);
+		psd_t[i] = texneut.GetT(i);
+	}
+
+	const Input::QDCInput& qdc = input.GetQDC();
+	nqdc = qdc.GetNHits();
+	for (size_t i = 0; i < nqdc; i++) {
+		qdc_chan[i] = qdc.GetChan(i);
+		qdc_h[i] = qdc.GetQH(i);
+		qdc_l[i] = qdc.GetQL(i);
+	}
+
+	const Input::TDCInput& tdc = input.GetTDC();
+	ntdc = 0;
+	for (size_t ch = 0; ch < TDC_CHAN_COUNT; ch++) {
+		for (size_t hit = 0; hit < tdc.GetNHits(ch); hit++) {
+			tdc_id[ntdc] = ch * TDC_HIT_COUNT + hit;
+			tdc_t[ntdc] = tdc.t[ch][hit];
+			ntdc++;
+		}
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t HitList::Convert(const string& infile, const string& itreeName, const string& outfile, Input::Mode mode) {
+	unique_ptr<TFile> in(TFile::Open(infile.c_str()));
+	if (!in || in->IsZombie()) throw invalid_argument(string(BOLDRED) + string("Could not open ") + infile + string(" for conversion") + string(RESET));
+
+	TTreeReader reader(itreeName.c_str(), in.get());
+	Input input(reader, mode);
+
+	// LZ4 decompresses much faster than the default, which is what matters for re-sorting
+	unique_ptr<TFile> out(TFile::Open(outfile.c_str(), "RECREATE", "", ROOT::CompressionSettings(ROOT::RCompressionSetting::EAlgorithm::kLZ4, 4)));
+	if (!out || out->IsZombie()) throw invalid_argument(string(BOLDRED) + string("Could not create ") + outfile + string(RESET));
+
+	TTree* tree = new TTree(TreeName, "Zero-suppressed hit lists");
+	tree->SetDirectory(out.get());
+	auto event = make_unique<Event>();
+	event->Branch(tree);
+
+	size_t nevents = 0;
+	while (reader.Next()) {
+		int badBefore = input.badevt;
+		input.ReadAndRefactor();
+		event->Fill(input, input.badevt != badBefore);
+		tree->Fill();
+		nevents++;
+	}
+
+	out->cd();
+	tree->Write();
+	out->Close();
+	return nevents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
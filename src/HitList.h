@@ -0,0 +1,70 @@
+/* Compact, zero-suppressed intermediate event format. A hit-list file holds
+ * one entry per SpecTcl event, but instead of ~2,000 dense double columns it
+ * only stores the channels that fired, as variable-length integer arrays
+ * matching the Input::GobbiInput, TexNeutInput, QDCInput and TDCInput hit
+ * lists. Channel ids are the flat column indices used by Input, i.e.
+ * (board - 1) * HINP_CHAN_COUNT + chan for HINP, (chip - 1) * PSD_CHAN_COUNT
+ * + chan for PSD and chan * TDC_HIT_COUNT + hit for the TDC.
+ *
+ * Files are written once per run by `sort --convert` and read back by Input
+ * in Mode::Sparse.
+ */
+
+#ifndef HitList_H
+#define HitList_H
+
+#include <Rtypes.h>
+
+#include <string>
+
+#include "Input.h"
+
+class TTree;
+
+namespace HitList {
+
+	// Name of the tree inside a hit-list file
+	const char* const TreeName = "hits";
+
+	// Name of the hit-list file for a run, e.g. run-614.hits.root
+	std::string FileName(int runnum);
+
+	// One event as stored on disk
+	struct Event {
+		UChar_t bad; // event was rejected by Input (non-zero first TDC word)
+
+		UShort_t nhinp;
+		UShort_t hinp_id[HINP_NCOLUMNS];
+		UInt_t hinp_e[HINP_NCOLUMNS];
+		UInt_t hinp_eLo[HINP_NCOLUMNS];
+		UInt_t hinp_t[HINP_NCOLUMNS];
+
+		UShort_t npsd;
+		UShort_t psd_id[PSD_NCOLUMNS];
+		UInt_t psd_a[PSD_NCOLUMNS];
+		UInt_t psd_b[PSD_NCOLUMNS];
+		UInt_t psd_c[PSD_NCOLUMNS];
+		UInt_t psd_t[PSD_NCOLUMNS];
+
+		UShort_t nqdc;
+		UShort_t qdc_chan[QDC_CHAN_COUNT];
+		UInt_t qdc_h[QDC_CHAN_COUNT];
+		UInt_t qdc_l[QDC_CHAN_COUNT];
+
+		UShort_t ntdc;
+		UShort_t tdc_id[TDC_NCOLUMNS];
+		Double_t tdc_t[TDC_NCOLUMNS];
+
+		// Create the output branches in a tree
+		void Branch(TTree*);
+
+		// Copy the hit lists of the current event out of an Input object
+		void Fill(const Input&, bool isBad);
+	};
+
+	// Convert a SpecTcl run file into a hit-list file, returns the number of events written
+	size_t Convert(const std::string& infile, const std::string& itreeName, const std::string& outfile, Input::Mode mode);
+
+}
+
+#endif
@@ -15,8 +15,15 @@
  */
 
 #include "Input.h"
+#include "RawUnpacker.h"
+
+#include <TTree.h>
+#include <TTreeReaderArray.h>
 
 #include <cmath>
+#include <exception>
+
+#include <stuffing.hpp>
 
 using namespace std;
 
@@ -82,23 +89,70 @@ vector<string> Input::GenerateColumnNamesTDC() {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+Input::Mode Input::ParseMode(const string& name) {
+	if (name == "reader") return Mode::Reader;
+	if (name == "bulk") return Mode::Bulk;
+	if (name == "sparse") return Mode::Sparse;
+	if (name == "raw") return Mode::Raw;
+	throw invalid_argument(string(BOLDRED) + string("Unknown input mode ") + name + string(RESET));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/* Writes the indices of all channels holding a valid ADC value (1 <= v < 16384)
+ * into index and returns how many there are. The test is done for all channels
+ * first in a branch-free loop the compiler can vectorize, then the indices are
+ * compacted without branching on the data. NaN fails both comparisons, so empty
+ * channels need no separate isnan test.
+ */
+size_t Input::ZeroSuppress(const double* values, size_t n, size_t* index) {
+	bool valid[HINP_NCOLUMNS];
+	for (size_t i = 0; i < n; i++) valid[i] = (values[i] >= 1.) & (values[i] < 16384.);
+
+	size_t nhit = 0;
+	for (size_t i = 0; i < n; i++) {
+		index[nhit] = i;
+		nhit += valid[i];
+	}
+	return nhit;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 /******** NON-STATIC FUNCTIONS ********/
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-Input::Input(TTreeReader& r) : reader(r) {
+// Branch names and types must match HitList::Event::Branch
+struct Input::SparseReaders {
+	TTreeReaderValue<UChar_t> bad;
+	TTreeReaderArray<UShort_t> hinp_id;
+	TTreeReaderArray<UInt_t> hinp_e, hinp_eLo, hinp_t;
+	TTreeReaderArray<UShort_t> psd_id;
+	TTreeReaderArray<UInt_t> psd_a, psd_b, psd_c, psd_t;
+	TTreeReaderArray<UShort_t> qdc_chan;
+	TTreeReaderArray<UInt_t> qdc_h, qdc_l;
+	TTreeReaderArray<UShort_t> tdc_id;
+	TTreeReaderArray<Double_t> tdc_t;
+
+	SparseReaders(TTreeReader& r) :
+		bad(r, "bad"),
+		hinp_id(r, "hinp_id"), hinp_e(r, "hinp_e"), hinp_eLo(r, "hinp_eLo"), hinp_t(r, "hinp_t"),
+		psd_id(r, "psd_id"), psd_a(r, "psd_a"), psd_b(r, "psd_b"), psd_c(r, "psd_c"), psd_t(r, "psd_t"),
+		qdc_chan(r, "qdc_chan"), qdc_h(r, "qdc_h"), qdc_l(r, "qdc_l"),
+		tdc_id(r, "tdc_id"), tdc_t(r, "tdc_t") {}
+};
 
-	// Pre-alocate required vector memory
-	gobbi.eRVs.reserve(HINP_NCOLUMNS);
-	gobbi.eLoRVs.reserve(HINP_NCOLUMNS);
-	gobbi.tRVs.reserve(HINP_NCOLUMNS);
-	texneut.aRVs.reserve(PSD_NCOLUMNS);
-	texneut.bRVs.reserve(PSD_NCOLUMNS);
-	texneut.cRVs.reserve(PSD_NCOLUMNS);
-	texneut.tRVs.reserve(PSD_NCOLUMNS);
-	qdc.qhRVs.reserve(QDC_CHAN_COUNT);
-	qdc.qlRVs.reserve(QDC_CHAN_COUNT);
-	tdc.tRVs.reserve(TDC_NCOLUMNS);
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Input::Input(TTreeReader& r, Mode m) : reader(&r), mode(m) {
+	if (mode == Mode::Raw) throw invalid_argument(string(BOLDRED) + string("Raw input is not read through a TTreeReader") + string(RESET));
+
+	// Hit-list files already hold only the fired channels, one array per parameter
+	if (mode == Mode::Sparse) {
+		sparse = make_unique<SparseReaders>(*reader);
+		return;
+	}
 
 	// Generate column names for reading from input tree
 	vector<string> e_columns     = GenerateColumnNamesHINP("e");
@@ -111,39 +165,80 @@ Input::Input(TTreeReader& r) : reader(r) {
 	vector<string> qh_columns    = GenerateColumnNamesQDC("h");
 	vector<string> ql_columns    = GenerateColumnNamesQDC("l");
 	vector<string> tdct_columns  = GenerateColumnNamesTDC();
+
+	// Bulk mode reads the branches directly, so no reader values are created.
+	// The columns are attached to the tree once the first entry is loaded.
+	if (mode == Mode::Bulk) {
+		for (size_t i = 0; i < HINP_NCOLUMNS; i++) {
+			gobbi.eCols.emplace_back(e_columns[i]);
+			gobbi.eLoCols.emplace_back(eLo_columns[i]);
+			gobbi.tCols.emplace_back(hinpt_columns[i]);
+		}
+		for (size_t i = 0; i < PSD_NCOLUMNS; i++) {
+			texneut.aCols.emplace_back(a_columns[i]);
+			texneut.bCols.emplace_back(b_columns[i]);
+			texneut.cCols.emplace_back(c_columns[i]);
+			texneut.tCols.emplace_back(psdt_columns[i]);
+		}
+		for (size_t i = 0; i < QDC_CHAN_COUNT; i++) {
+			qdc.qhCols.emplace_back(qh_columns[i]);
+			qdc.qlCols.emplace_back(ql_columns[i]);
+		}
+		for (size_t i = 0; i < TDC_NCOLUMNS; i++)
+			tdc.tCols.emplace_back(tdct_columns[i]);
+		return;
+	}
+
+	// Pre-alocate required vector memory
+	gobbi.eRVs.reserve(HINP_NCOLUMNS);
+	gobbi.eLoRVs.reserve(HINP_NCOLUMNS);
+	gobbi.tRVs.reserve(HINP_NCOLUMNS);
+	texneut.aRVs.reserve(PSD_NCOLUMNS);
+	texneut.bRVs.reserve(PSD_NCOLUMNS);
+	texneut.cRVs.reserve(PSD_NCOLUMNS);
+	texneut.tRVs.reserve(PSD_NCOLUMNS);
+	qdc.qhRVs.reserve(QDC_CHAN_COUNT);
+	qdc.qlRVs.reserve(QDC_CHAN_COUNT);
+	tdc.tRVs.reserve(TDC_NCOLUMNS);
 	
 	//// Create reader values for all columns, iteratively
 
 	// HINP
 	for (size_t i = 0; i < HINP_NCOLUMNS; i++) {
-		gobbi.eRVs.push_back({reader, e_columns[i].c_str()});
-		gobbi.eLoRVs.push_back({reader, eLo_columns[i].c_str()});
-		gobbi.tRVs.push_back({reader, hinpt_columns[i].c_str()});
+		gobbi.eRVs.push_back({*reader, e_columns[i].c_str()});
+		gobbi.eLoRVs.push_back({*reader, eLo_columns[i].c_str()});
+		gobbi.tRVs.push_back({*reader, hinpt_columns[i].c_str()});
 	}
 
 	// PSD
 	for (size_t i = 0; i < PSD_NCOLUMNS; i++) {
-		texneut.aRVs.push_back({reader, a_columns[i].c_str()});
-		texneut.bRVs.push_back({reader, b_columns[i].c_str()});
-		texneut.cRVs.push_back({reader, c_columns[i].c_str()});
-		texneut.tRVs.push_back({reader, psdt_columns[i].c_str()});
+		texneut.aRVs.push_back({*reader, a_columns[i].c_str()});
+		texneut.bRVs.push_back({*reader, b_columns[i].c_str()});
+		texneut.cRVs.push_back({*reader, c_columns[i].c_str()});
+		texneut.tRVs.push_back({*reader, psdt_columns[i].c_str()});
 	}
 
 	// QDC
 	for (size_t i = 0; i < QDC_CHAN_COUNT; i++) {
-		qdc.qhRVs.push_back({reader, qh_columns[i].c_str()});
-		qdc.qlRVs.push_back({reader, ql_columns[i].c_str()});
+		qdc.qhRVs.push_back({*reader, qh_columns[i].c_str()});
+		qdc.qlRVs.push_back({*reader, ql_columns[i].c_str()});
 	}
 
 	// TDC
 	for (size_t i = 0; i < TDC_NCOLUMNS; i++) {
-		tdc.tRVs.push_back({reader, tdct_columns[i].c_str()});
+		tdc.tRVs.push_back({*reader, tdct_columns[i].c_str()});
 	}
 
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+Input::Input(Mode m) : reader(nullptr), mode(m), raw(make_unique<RawUnpacker>()) {
+	if (mode != Mode::Raw) throw invalid_argument(string(BOLDRED) + string("Only raw input can be created without a TTreeReader") + string(RESET));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 Input::~Input() {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -153,6 +248,16 @@ void Input::ReadAndRefactor() {
 	texneut.clear();
 	qdc.clear();
 	tdc.clear();
+
+	if (mode == Mode::Raw) throw logic_error("Raw input events are loaded with ReadRaw");
+	if (mode == Mode::Bulk) ReadFromBulk();
+	else if (mode == Mode::Sparse) ReadFromSparse();
+	else ReadFromReaders();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Input::ReadFromReaders() {
 	
 	// Loop through TDC channels to retrieve time hit information
 	size_t chan, hit;
@@ -172,8 +277,7 @@ void Input::ReadAndRefactor() {
 		if (isnan(tdc_t) || (abs(tdc_t) >= 10000)) continue;
 		chan = i / (size_t)TDC_HIT_COUNT;
 		//if (chan > 3) cout << chan << " " << tdc_t << endl;
-		tdc.Nhits[chan]++;
-		tdc.t[chan].push_back(tdc_t);
+		tdc.Add(chan, tdc_t);
 	}
 	
 	// Loop through HINP boards and channels and retrieve hit information
@@ -181,12 +285,7 @@ void Input::ReadAndRefactor() {
 	for (size_t i = 0; i < HINP_NCOLUMNS; i++) {
 		e = *(gobbi.eRVs[i]); //TODO this returns the max 64-bit value for empty channels, temp cut out > 16384
 		if (isnan(e) || (e == 0) || (e >= 16384)) continue;
-		gobbi.Nhits++;
-		gobbi.board.push_back((i / (size_t)HINP_CHAN_COUNT) + 1);
-		gobbi.chan.push_back(i % (size_t)HINP_CHAN_COUNT);
-		gobbi.e.push_back(e);
-		gobbi.eLo.push_back((size_t)(*(gobbi.eLoRVs[i])));
-		gobbi.t.push_back((size_t)(*(gobbi.tRVs[i])));
+		gobbi.Add((i / (size_t)HINP_CHAN_COUNT) + 1, i % (size_t)HINP_CHAN_COUNT, e, (size_t)(*(gobbi.eLoRVs[i])), (size_t)(*(gobbi.tRVs[i])));
 	}
 	
 	// Loop through PSD chips and channels and retrieve hit information
@@ -194,13 +293,7 @@ void Input::ReadAndRefactor() {
 	for (size_t i = 0; i < PSD_NCOLUMNS; i++) {
 		t = *(texneut.tRVs[i]); //TODO this returns the max 64-bit value for empty channels, temp cut out > 16384
 		if (isnan(t) || (t == 0) || (t >= 16384)) continue;
-		texneut.Nhits++;
-		texneut.chip.push_back((i / (size_t)PSD_CHAN_COUNT) + 1);
-		texneut.chan.push_back(i % (size_t)PSD_CHAN_COUNT);
-		texneut.a.push_back((size_t)(*(texneut.aRVs[i])));
-		texneut.b.push_back((size_t)(*(texneut.bRVs[i])));
-		texneut.c.push_back((size_t)(*(texneut.cRVs[i])));
-		texneut.t.push_back(t);
+		texneut.Add((i / (size_t)PSD_CHAN_COUNT) + 1, i % (size_t)PSD_CHAN_COUNT, (size_t)(*(texneut.aRVs[i])), (size_t)(*(texneut.bRVs[i])), (size_t)(*(texneut.cRVs[i])), t);
 	  }
 	
 	// Loop through QDC channels to retrieve high and low range hit information
@@ -208,15 +301,128 @@ void Input::ReadAndRefactor() {
 	for (size_t i = 0; i < QDC_CHAN_COUNT; i++) {
 		qh = *(qdc.qhRVs[i]); //TODO this returns the max 64-bit value for empty channels, temp cut out > 16384
 		if (isnan(qh) || (qh == 0) || (qh >= 16384)) continue;
-		qdc.Nhits++;
-		qdc.chan.push_back(i);
-		qdc.qh.push_back(qh);
-		qdc.ql.push_back((size_t)(*(qdc.qlRVs[i])));
+		qdc.Add(i, qh, (size_t)(*(qdc.qlRVs[i])));
 	}
 	
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void Input::AttachBulkColumns(TTree* tree) {
+	for (auto& col : gobbi.eCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : gobbi.eLoCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : gobbi.tCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : texneut.aCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : texneut.bCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : texneut.cCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : texneut.tCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : qdc.qhCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : qdc.qlCols) col.Attach(tree, &bulkBuffer);
+	for (auto& col : tdc.tCols) col.Attach(tree, &bulkBuffer);
+	bulkTree = tree;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/* Same selection as ReadFromReaders, but values come from basket-sized blocks
+ * decoded by BulkColumn. Only the column that decides whether a channel fired
+ * (HINP e, PSD t, QDC h) is read for every channel; the other columns are only
+ * touched for channels that passed zero suppression.
+ */
+void Input::ReadFromBulk() {
+
+	// The reader moves to a new TTree at each file boundary of a chain
+	TTree* tree = reader->GetTree()->GetTree();
+	if (tree != bulkTree) AttachBulkColumns(tree);
+	Long64_t entry = tree->GetReadEntry();
+
+	// Loop through TDC channels to retrieve time hit information
+	double tdc_t;
+	for (size_t i = 0; i < TDC_NCOLUMNS; i++) {
+		tdc_t = tdc.tCols[i].Get(entry);
+		if (i == 0 && tdc_t != 0) {
+			badevt++;
+			return;
+		}
+		if (isnan(tdc_t) || (abs(tdc_t) >= 10000)) continue;
+		tdc.Add(i / (size_t)TDC_HIT_COUNT, tdc_t);
+	}
+
+	double values[HINP_NCOLUMNS];
+	size_t index[HINP_NCOLUMNS];
+	size_t nhit;
+
+	// HINP boards and channels
+	for (size_t i = 0; i < HINP_NCOLUMNS; i++) values[i] = gobbi.eCols[i].Get(entry);
+	nhit = ZeroSuppress(values, HINP_NCOLUMNS, index);
+	for (size_t k = 0; k < nhit; k++) {
+		size_t i = index[k];
+		gobbi.Add((i / (size_t)HINP_CHAN_COUNT) + 1, i % (size_t)HINP_CHAN_COUNT, (size_t)values[i], (size_t)gobbi.eLoCols[i].Get(entry), (size_t)gobbi.tCols[i].Get(entry));
+	}
+
+	// PSD chips and channels
+	for (size_t i = 0; i < PSD_NCOLUMNS; i++) values[i] = texneut.tCols[i].Get(entry);
+	nhit = ZeroSuppress(values, PSD_NCOLUMNS, index);
+	for (size_t k = 0; k < nhit; k++) {
+		size_t i = index[k];
+		texneut.Add((i / (size_t)PSD_CHAN_COUNT) + 1, i % (size_t)PSD_CHAN_COUNT, (size_t)texneut.aCols[i].Get(entry), (size_t)texneut.bCols[i].Get(entry), (size_t)texneut.cCols[i].Get(entry), (size_t)values[i]);
+	}
+
+	// QDC channels
+	for (size_t i = 0; i < QDC_CHAN_COUNT; i++) values[i] = qdc.qhCols[i].Get(entry);
+	nhit = ZeroSuppress(values, QDC_CHAN_COUNT, index);
+	for (size_t k = 0; k < nhit; k++) {
+		size_t i = index[k];
+		qdc.Add(i, (size_t)values[i], (size_t)qdc.qlCols[i].Get(entry));
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/* Hit-list files were zero suppressed when they were written, so this only
+ * unpacks the channel ids and copies the values.
+ */
+void Input::ReadFromSparse() {
+	SparseReaders& s = *sparse;
 
+	if (*s.bad) {
+		badevt++;
+		return;
+	}
 
+	for (size_t k = 0; k < s.tdc_id.GetSize(); k++)
+		tdc.Add(s.tdc_id[k] / (size_t)TDC_HIT_COUNT, s.tdc_t[k]);
+
+	for (size_t k = 0; k < s.hinp_id.GetSize(); k++) {
+		size_t i = s.hinp_id[k];
+		gobbi.Add((i / (size_t)HINP_CHAN_COUNT) + 1, i % (size_t)HINP_CHAN_COUNT, s.hinp_e[k], s.hinp_eLo[k], s.hinp_t[k]);
+	}
+
+	for (size_t k = 0; k < s.psd_id.GetSize(); k++) {
+		size_t i = s.psd_id[k];
+		texneut.Add((i / (size_t)PSD_CHAN_COUNT) + 1, i % (size_t)PSD_CHAN_COUNT, s.psd_a[k], s.psd_b[k], s.psd_c[k], s.psd_t[k]);
+	}
+
+	for (size_t k = 0; k < s.qdc_chan.GetSize(); k++)
+		qdc.Add(s.qdc_chan[k], s.qdc_h[k], s.qdc_l[k]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Input::ReadRaw(uint16_t* body, size_t nwords) {
+	gobbi.clear();
+	texneut.clear();
+	qdc.clear();
+	tdc.clear();
+
+	// Malformed events and events without a TDC reference are dropped, like bad events from SpecTcl
+	if (!raw->Unpack(body, nwords, gobbi, texneut, qdc, tdc)) {
+		gobbi.clear();
+		texneut.clear();
+		qdc.clear();
+		tdc.clear();
+		badevt++;
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
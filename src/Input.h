@@ -16,6 +16,13 @@
 #include <TTreeReader.h>
 #include <TTreeReaderValue.h>
 
+#include "BulkColumn.h"
+#include "Span.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
 #include <optional>
 #include <vector>
@@ -28,6 +35,7 @@
 #define QDC_CHAN_COUNT 2 // CAEN v965, 16 channels with h and l each (32 total parameters)
 #define TDC_CHAN_COUNT 16 // CAEN v1190a, 128 channels can be configured to accept up to 16 hits each
 #define TDC_HIT_COUNT 3 // CAEN v1190a, 128 channels can be configured to accept up to 16 hits each
+#define TDC_LSB_NS 0.1 // CAEN v1190a time bin in ns, only used when unpacking raw data
 
 // Number of columns per parameter type in the input file
 #define HINP_NCOLUMNS HINP_BOARD_COUNT * HINP_CHAN_COUNT
@@ -36,13 +44,33 @@
 
 // TODO: add private "checked access" helper function to all structs for boundary checking in getter functions
 
+// Hit buffers are fixed-capacity structure-of-arrays sized by the number of
+// columns, so nothing is allocated per event. The SpecTcl columns fill each
+// entry at most once, but raw input is not trusted: Add() refuses a hit once
+// the buffer is full and returns false, and the caller drops the event. Ids
+// are 16-bit; ADC values are 32-bit, saturated by Pack() so that garbage in
+// empty secondary columns cannot wrap around.
+
+class RawUnpacker;
+
 class Input {
 
 public:
-	Input(TTreeReader&);
+	// Ways of reading the SpecTcl tree
+	enum class Mode {
+		Reader, // one TTreeReaderValue per column, dereferenced every event
+		Bulk,   // whole baskets per column through ROOT bulk I/O, see BulkColumn
+		Sparse, // zero-suppressed hit lists written by sort --convert, see HitList
+		Raw     // NSCLDAQ event bodies passed to ReadRaw, see RawUnpacker
+	};
+	static Mode ParseMode(const std::string&);
+
+	Input(TTreeReader&, Mode mode = Mode::Reader);
+	Input(Mode mode); // raw input only, events are loaded with ReadRaw
 	~Input();
 
 	void ReadAndRefactor();
+	void ReadRaw(uint16_t* body, size_t nwords);
 
 	int badevt = 0;
 
@@ -54,21 +82,30 @@ public:
 		std::vector<TTreeReaderValue<double>> eLoRVs;
 		std::vector<TTreeReaderValue<double>> tRVs;
 
-		// Vectors for Gobbi (HINP) hit values
+		// Columns for bulk reading
+		std::vector<BulkColumn> eCols;
+		std::vector<BulkColumn> eLoCols;
+		std::vector<BulkColumn> tCols;
+
+		// Buffers for Gobbi (HINP) hit values
 		size_t Nhits{0};
-		std::vector<size_t> board;
-		std::vector<size_t> chan;
-		std::vector<size_t> e;
-		std::vector<size_t> eLo;
-		std::vector<size_t> t;
+		uint16_t board[HINP_NCOLUMNS];
+		uint16_t chan[HINP_NCOLUMNS];
+		uint32_t e[HINP_NCOLUMNS];
+		uint32_t eLo[HINP_NCOLUMNS];
+		uint32_t t[HINP_NCOLUMNS];
 
-		void clear() {
-			Nhits = 0;
-			board.clear();
-			chan.clear();
-			e.clear();
-			eLo.clear();
-			t.clear();
+		void clear() { Nhits = 0; }
+
+		bool Add(size_t b, size_t c, size_t energy, size_t energyLo, size_t time) {
+			if (Nhits >= HINP_NCOLUMNS) return false;
+			board[Nhits] = b;
+			chan[Nhits] = c;
+			e[Nhits] = Pack(energy);
+			eLo[Nhits] = Pack(energyLo);
+			t[Nhits] = Pack(time);
+			Nhits++;
+			return true;
 		}
 
 		// Hit getter functions
@@ -78,6 +115,13 @@ public:
 		size_t GetE(size_t i) const     { return e[i]; }
 		size_t GetELo(size_t i) const   { return eLo[i]; }
 		size_t GetT(size_t i) const     { return t[i]; }
+
+		// Views of the hits of the current event
+		Span<uint16_t> Boards() const { return {board, Nhits}; }
+		Span<uint16_t> Chans() const  { return {chan, Nhits}; }
+		Span<uint32_t> Es() const     { return {e, Nhits}; }
+		Span<uint32_t> ELos() const   { return {eLo, Nhits}; }
+		Span<uint32_t> Ts() const     { return {t, Nhits}; }
 	};
 
 	struct TexNeutInput {
@@ -87,23 +131,33 @@ public:
 		std::vector<TTreeReaderValue<double>> cRVs;
 		std::vector<TTreeReaderValue<double>> tRVs;
 
-		// Vectors for TexNeut (PSD) hit values
+		// Columns for bulk reading
+		std::vector<BulkColumn> aCols;
+		std::vector<BulkColumn> bCols;
+		std::vector<BulkColumn> cCols;
+		std::vector<BulkColumn> tCols;
+
+		// Buffers for TexNeut (PSD) hit values
 		size_t Nhits{0};
-		std::vector<size_t> chip;
-		std::vector<size_t> chan;
-		std::vector<size_t> a;
-		std::vector<size_t> b;
-		std::vector<size_t> c;
-		std::vector<size_t> t;
+		uint16_t chip[PSD_NCOLUMNS];
+		uint16_t chan[PSD_NCOLUMNS];
+		uint32_t a[PSD_NCOLUMNS];
+		uint32_t b[PSD_NCOLUMNS];
+		uint32_t c[PSD_NCOLUMNS];
+		uint32_t t[PSD_NCOLUMNS];
 
-		void clear() {
-			Nhits = 0;
-			chip.clear();
-			chan.clear();
-			a.clear();
-			b.clear();
-			c.clear();
-			t.clear();
+		void clear() { Nhits = 0; }
+
+		bool Add(size_t ch, size_t cn, size_t qa, size_t qb, size_t qc, size_t time) {
+			if (Nhits >= PSD_NCOLUMNS) return false;
+			chip[Nhits] = ch;
+			chan[Nhits] = cn;
+			a[Nhits] = Pack(qa);
+			b[Nhits] = Pack(qb);
+			c[Nhits] = Pack(qc);
+			t[Nhits] = Pack(time);
+			Nhits++;
+			return true;
 		}
 
 		// Hit getter functions
@@ -114,24 +168,52 @@ public:
 		size_t GetB(size_t i) const    { return b[i]; }
 		size_t GetC(size_t i) const    { return c[i]; }
 		size_t GetT(size_t i) const    { return t[i]; }
+
+		// Views of the hits of the current event
+		Span<uint16_t> Chips() const { return {chip, Nhits}; }
+		Span<uint16_t> Chans() const { return {chan, Nhits}; }
+		Span<uint32_t> As() const    { return {a, Nhits}; }
+		Span<uint32_t> Bs() const    { return {b, Nhits}; }
+		Span<uint32_t> Cs() const    { return {c, Nhits}; }
+		Span<uint32_t> Ts() const    { return {t, Nhits}; }
+
+		// Copy the hits into the vectors TNLIB's event::CustomFillNecessary takes.
+		// The vectors are reused by the caller, so they stop allocating after the first events.
+		void FillTNLIBVectors(std::vector<size_t>& chipv, std::vector<size_t>& chanv, std::vector<size_t>& av,
+		                      std::vector<size_t>& bv, std::vector<size_t>& cv, std::vector<size_t>& tv) const {
+			chipv.assign(chip, chip + Nhits);
+			chanv.assign(chan, chan + Nhits);
+			av.assign(a, a + Nhits);
+			bv.assign(b, b + Nhits);
+			cv.assign(c, c + Nhits);
+			tv.assign(t, t + Nhits);
+		}
 	};
 	
 	struct QDCInput {
 		// Vectors for input branch readers
 		std::vector<TTreeReaderValue<double>> qhRVs; // high range Q
 		std::vector<TTreeReaderValue<double>> qlRVs; // low range Q
+
+		// Columns for bulk reading
+		std::vector<BulkColumn> qhCols;
+		std::vector<BulkColumn> qlCols;
 		
-		// Vectors for QDC hit values
+		// Buffers for QDC hit values
 		size_t Nhits{0};
-		std::vector<size_t> chan;
-		std::vector<size_t> qh;
-		std::vector<size_t> ql;
+		uint16_t chan[QDC_CHAN_COUNT];
+		uint32_t qh[QDC_CHAN_COUNT];
+		uint32_t ql[QDC_CHAN_COUNT];
 		
-		void clear() {
-			Nhits = 0;
-			chan.clear();
-			qh.clear();
-			ql.clear();
+		void clear() { Nhits = 0; }
+
+		bool Add(size_t c, size_t high, size_t low) {
+			if (Nhits >= QDC_CHAN_COUNT) return false;
+			chan[Nhits] = c;
+			qh[Nhits] = Pack(high);
+			ql[Nhits] = Pack(low);
+			Nhits++;
+			return true;
 		}
 		
 		// Hit getter functions
@@ -139,33 +221,45 @@ public:
 		size_t GetChan(size_t i) const { return chan[i]; }
 		size_t GetQH(size_t i) const { return qh[i]; }
 		size_t GetQL(size_t i) const { return ql[i]; }
+
+		// Views of the hits of the current event
+		Span<uint16_t> Chans() const { return {chan, Nhits}; }
+		Span<uint32_t> QHs() const   { return {qh, Nhits}; }
+		Span<uint32_t> QLs() const   { return {ql, Nhits}; }
 	};
 	
 	struct TDCInput {
 		// Vector for input branch readers
 		std::vector<TTreeReaderValue<double>> tRVs; // flattened 2D array for channels and hits
+
+		// Columns for bulk reading
+		std::vector<BulkColumn> tCols;
 		
-		// Vector for TDC hit values
-		size_t Nhits[TDC_CHAN_COUNT]; // one for each channel
-		std::vector<double> t[TDC_CHAN_COUNT]; // outermost array stores channels, innermost vector stores hits
+		// Buffer for TDC hit values, the first Nhits[ch] entries of t[ch] are valid
+		uint16_t Nhits[TDC_CHAN_COUNT]; // one for each channel
+		double t[TDC_CHAN_COUNT][TDC_HIT_COUNT]; // outer index is the channel, inner index the hit
 		
 		void clear() {
-			for (int i = 0;i < TDC_CHAN_COUNT; i++) {
-				Nhits[i] = 0;
-				t[i].clear();
-			}
+			for (int i = 0;i < TDC_CHAN_COUNT; i++) Nhits[i] = 0;
+		}
+
+		bool Add(size_t ch, double time) {
+			if (ch >= TDC_CHAN_COUNT || Nhits[ch] >= TDC_HIT_COUNT) return false;
+			t[ch][Nhits[ch]++] = time;
+			return true;
 		}
 		
 		// Hit getter functions
 		size_t GetNHits(size_t ch) const { return Nhits[ch]; }
-		std::optional<double> GetT(size_t ch, size_t i) { return (i >= t[ch].size()) ? std::nullopt : std::optional<double>(t[ch][i]); }
+		std::optional<double> GetT(size_t ch, size_t i) const { return (i >= Nhits[ch]) ? std::nullopt : std::optional<double>(t[ch][i]); }
+		Span<double> Ts(size_t ch) const { return {t[ch], Nhits[ch]}; }
 		
 		// Group channel hits into single vector for interface with TexNeut
 		// Make sure that this properly accesses the TDC channels dedicated to TexNeut (4-16 in my case)
 		// For now, only consider the first hit in each TDC channel
 		void FillTexNeutHitVectors(std::vector<size_t>& chan, std::vector<double>& tdct) const {
 			for (int ch = 0; ch < TDC_CHAN_COUNT; ch++) {
-				if (t[ch].size() == 0) continue;
+				if (Nhits[ch] == 0) continue;
 				chan.push_back(ch);
 				tdct.push_back(t[ch][0]);
 			}
@@ -179,16 +273,37 @@ public:
 	const TDCInput& GetTDC() const { return tdc; }
 
 private:
-	// TTreeReader reference for input
-	TTreeReader& reader;
+	// TTreeReader for input, null for raw input
+	TTreeReader* reader;
+	Mode mode;
+
+	// Tree the bulk columns are currently attached to, and their shared scratch buffer
+	TTree* bulkTree{nullptr};
+	TBufferFile bulkBuffer{TBuffer::kWrite, 32 * 1024};
+
+	// Array readers for hit-list files, only created in sparse mode
+	struct SparseReaders;
+	std::unique_ptr<SparseReaders> sparse;
+
+	// Unpacker for raw event bodies, only created in raw mode
+	std::unique_ptr<RawUnpacker> raw;
 
 	GobbiInput gobbi;
 	TexNeutInput texneut;
 	QDCInput qdc;
 	TDCInput tdc;
 
+	void ReadFromReaders();
+	void ReadFromBulk();
+	void ReadFromSparse();
+	void AttachBulkColumns(TTree*);
+
 	/******** PRIVATE STATIC HELPER FUNCTIONS ********/
 
+	static uint32_t Pack(size_t value) { return (uint32_t)std::min(value, (size_t)std::numeric_limits<uint32_t>::max()); }
+
+	static size_t ZeroSuppress(const double* values, size_t n, size_t* index);
+
 	static std::vector<std::string> GenerateColumnNamesHINP(const std::string&);
 	static std::vector<std::string> GenerateColumnNamesPSD(const std::string&);
 	static std::vector<std::string> GenerateColumnNamesQDC(const std::string&);
@@ -0,0 +1,115 @@
+/**
+ * This implementation file contains the LinearPID class, which identifies
+ * particles from a continuous PID value computed with the range-energy
+ * tables of the DeltaE detector material. See LinearPID.h.
+ */
+
+#include "LinearPID.h"
+
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <stuffing.hpp>
+
+#include "constants.h"
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LinearPID::LinearPID(SortConfig& config) : loss{nullptr, nullptr, nullptr, nullptr} {
+	// Particle lines, ordered by Z^2 A so that the thickness ratio falls
+	// along the list at any energy
+	const int ZA[NParticles][2] = {{1, 1}, {1, 2}, {1, 3}, {2, 3}, {2, 4}, {2, 6}, {3, 6}, {3, 7}};
+	for (int i = 0; i < NParticles; i++) {
+		particles[i].Z = ZA[i][0];
+		particles[i].A = ZA[i][1];
+		particles[i].mass = Mass_lookup.at({size_t(ZA[i][0]), size_t(ZA[i][1])});
+	}
+
+	const char* elements[4] = {"", "Hydrogen", "Helium", "Lithium"};
+	for (int Z = 1; Z <= 3; Z++) {
+		string file = config.GetLossDir() + elements[Z] + "_" + config.GetPIDLossSuffix() + ".loss";
+		if (!ifstream(file).good())
+			throw invalid_argument(string(BOLDRED) + string("Loss file ") + file + string(" for pidMode = linear does not exist or failed to open") + string(RESET));
+		loss[Z] = new CLoss2(file);
+	}
+
+	const vector<float>& thick = config.GetPIDDeltaThick();
+	if (thick.size() != 1 && thick.size() != 4)
+		throw invalid_argument(string(BOLDRED) + string("pidDeltaThick needs one value, or one per quadrant, for pidMode = linear") + string(RESET));
+	for (int quad = 0; quad < 4; quad++) {
+		deltaThick[quad] = thick[thick.size() == 1 ? 0 : quad];
+		if (!(deltaThick[quad] > 0))
+			throw invalid_argument(string(BOLDRED) + string("pidDeltaThick must be positive") + string(RESET));
+	}
+	cutWidth = config.GetPIDCutWidth();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LinearPID::~LinearPID() {
+	for (int Z = 1; Z <= 3; Z++) delete loss[Z];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Thickness crossed by a particle that lost dE and stopped with E, over the
+// detector thickness. 1 on the particle's own line.
+float LinearPID::ratio(int i, float E, float dE, float cosTheta, float thick) const {
+	const CLoss2* table = loss[particles[i].Z];
+	float A = particles[i].mass / m0;
+	return (table->getRange(E + dE, A) - table->getRange(E, A)) * cosTheta / thick;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+float LinearPID::getValue(int quad, float E, float dE, float cosTheta) const {
+	if (!(E > 0 && dE > 0 && cosTheta > 0)) return numeric_limits<float>::quiet_NaN();
+	float thick = deltaThick[quad];
+
+	// The point lies between the lines lo and lo+1 where the ratio goes from
+	// >= 1 to < 1. dE/dx goes as Z^2 A/E, so the ratio of the proton line
+	// over Z^2 A is a good first guess, which is then corrected by walking
+	// to the neighbouring pair. Outside the list the first or last pair is
+	// extrapolated.
+	float r0 = ratio(0, E, dE, cosTheta, thick);
+	int lo = 0;
+	while (lo < NParticles - 2 && particles[lo + 1].Z * particles[lo + 1].Z * particles[lo + 1].A <= r0) lo++;
+	float rlo = (lo == 0) ? r0 : ratio(lo, E, dE, cosTheta, thick);
+	float rhi = ratio(lo + 1, E, dE, cosTheta, thick);
+	while (rlo < 1 && lo > 0) {
+		lo--;
+		rhi = rlo;
+		rlo = ratio(lo, E, dE, cosTheta, thick);
+	}
+	while (rhi >= 1 && lo < NParticles - 2) {
+		lo++;
+		rlo = rhi;
+		rhi = ratio(lo + 1, E, dE, cosTheta, thick);
+	}
+	if (!(rlo > 0 && rhi > 0 && rlo != rhi)) return numeric_limits<float>::quiet_NaN();
+
+	// log(ratio) is close to linear between neighbouring lines
+	return lo + log(rlo) / log(rlo / rhi);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool LinearPID::getPID(float value, int& Z, int& A, float& mass) const {
+	Z = 0;
+	A = 0;
+	if (!(value > -0.5f && value < NParticles - 0.5f)) return false;
+	int i = lround(value);
+	if (fabs(value - i) > cutWidth) return false;
+	Z = particles[i].Z;
+	A = particles[i].A;
+	mass = particles[i].mass;
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,63 @@
+/**
+ * This header file contains the LinearPID class, an alternative to the banana
+ * gates of the pid class. For a measured (E, DeltaE) pair and each candidate
+ * particle, the range-energy tables of the DeltaE detector material give the
+ * thickness the particle would have crossed to lose DeltaE before stopping
+ * with E:
+ *
+ *   t = [R(E + DeltaE) - R(E)] cos(theta)
+ *
+ * Only the right particle gives t equal to the detector thickness. The ratio
+ * to the thickness falls steadily from p to 7Li, so interpolating log(ratio)
+ * between neighbouring particles gives a continuous PID value that is 0 on
+ * the proton line, 1 on the deuteron line and so on. A particle is
+ * identified by a 1D cut around the nearest integer, so no gates have to be
+ * drawn, and the only fitted parameter is the DeltaE thickness of each
+ * quadrant.
+ *
+ * It is selected with pidMode = linear and reads <Element>_<pidLossSuffix>.loss
+ * from lossDir. LossFiles has no silicon tables yet, so the mode is not set
+ * up in the shipped config until they are added.
+ */
+
+#ifndef LinearPID_H
+#define LinearPID_H
+
+#include "loss2.h"
+#include "SortConfig.h"
+
+class LinearPID {
+
+public:
+	LinearPID(SortConfig& config);
+	~LinearPID();
+	LinearPID(const LinearPID&) = delete;
+	LinearPID& operator=(const LinearPID&) = delete;
+
+	// PID value of a particle stopped in the E detector of a quadrant, NaN if
+	// the energies are not usable
+	float getValue(int quad, float E, float dE, float cosTheta) const;
+
+	// Returns true and loads Z, A and mass if value is within the cut width
+	// of a particle line
+	bool getPID(float value, int& Z, int& A, float& mass) const;
+
+	static const int NParticles = 8;
+
+private:
+	struct Particle {
+		int Z;
+		int A;
+		float mass;
+	};
+	Particle particles[NParticles]; // in order of increasing stopping power
+
+	CLoss2* loss[4];                // range tables for Z = 1..3 in the DeltaE material, index by Z
+	float deltaThick[4];            // DeltaE thickness of each quadrant in mg/cm2
+	float cutWidth;                 // accepted distance from a particle line
+
+	float ratio(int particle, float E, float dE, float cosTheta, float thick) const;
+
+};
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * This implementation file contains the RawPipeline class, see RawPipeline.h
+ * for the ring item layout it expects.
+ */
+
+#include "RawPipeline.h"
+
+#include <cstdio>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include <stuffing.hpp>
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RawPipeline::RawPipeline(size_t capacity0, size_t batchSize0) : capacity(capacity0), batchSize(batchSize0) {
+	if (capacity == 0 || batchSize == 0) throw invalid_argument(string(BOLDRED) + string("Raw pipeline capacity and batch size must be positive") + string(RESET));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t RawPipeline::ReadRun(const vector<string>& segments, int run) {
+	RawBatch batch;
+	batch.run = run;
+	long long nevents = 0;
+
+	// Large stdio buffer, ring items are small and read one at a time
+	vector<char> iobuf(16 << 20);
+
+	for (const string& path : segments) {
+		unique_ptr<FILE, int (*)(FILE*)> file(fopen(path.c_str(), "rb"), fclose);
+		if (!file) {
+			cerr << "Error opening raw event file " << path << "!" << endl;
+			continue;
+		}
+		setvbuf(file.get(), iobuf.data(), _IOFBF, iobuf.size());
+
+		uint32_t header[2];
+		vector<char> skip;
+		while (fread(header, sizeof(uint32_t), 2, file.get()) == 2) {
+			uint32_t size = header[0];
+			uint32_t type = header[1];
+			if (size < 3 * sizeof(uint32_t)) {
+				cerr << "Corrupt ring item (size " << size << ") in " << path << ", skipping rest of file" << endl;
+				break;
+			}
+			size_t remaining = size - 2 * sizeof(uint32_t);
+
+			if (type != PhysicsEvent) {
+				skip.resize(remaining);
+				if (fread(skip.data(), 1, remaining, file.get()) != remaining) break;
+				continue;
+			}
+
+			// Skip the body header, if there is one
+			uint32_t bodyHeaderSize;
+			if (fread(&bodyHeaderSize, sizeof(uint32_t), 1, file.get()) != 1) break;
+			remaining -= sizeof(uint32_t);
+			if (bodyHeaderSize > sizeof(uint32_t)) {
+				size_t extra = bodyHeaderSize - sizeof(uint32_t);
+				if (extra > remaining) break;
+				skip.resize(extra);
+				if (fread(skip.data(), 1, extra, file.get()) != extra) break;
+				remaining -= extra;
+			}
+
+			// Copy the body straight into the batch
+			size_t nwords = remaining / sizeof(uint16_t);
+			size_t start = batch.words.size();
+			batch.words.resize(start + nwords);
+			if (fread(batch.words.data() + start, sizeof(uint16_t), nwords, file.get()) != nwords) {
+				batch.words.resize(start);
+				break;
+			}
+			if (remaining % sizeof(uint16_t)) fgetc(file.get());
+			batch.offsets.push_back(batch.words.size());
+			nevents++;
+
+			if (batch.Size() >= batchSize) {
+				long long next = nevents;
+				Push(batch);
+				batch.run = run;
+				batch.firstEntry = next;
+			}
+		}
+	}
+	if (batch.Size() > 0) Push(batch);
+	return nevents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RawPipeline::Push(RawBatch& batch) {
+	unique_lock<std::mutex> lock(mutex);
+	notFull.wait(lock, [this] { return queue.size() < capacity; });
+	queue.push_back(std::move(batch));
+	lock.unlock();
+	notEmpty.notify_one();
+
+	// The moved-from batch is reused by the reader
+	batch.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RawPipeline::Close() {
+	{
+		lock_guard<std::mutex> lock(mutex);
+		closed = true;
+	}
+	notEmpty.notify_all();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool RawPipeline::Pop(RawBatch& batch) {
+	unique_lock<std::mutex> lock(mutex);
+	notEmpty.wait(lock, [this] { return !queue.empty() || closed; });
+	if (queue.empty()) return false;
+	batch = std::move(queue.front());
+	queue.pop_front();
+	lock.unlock();
+	notFull.notify_one();
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+vector<string> RawPipeline::FindSegments(const string& dir, int run) {
+	vector<string> segments;
+	for (int segment = 0; segment < 100; segment++) {
+		ostringstream name;
+		name << dir << "run-" << setfill('0') << setw(4) << run << "-" << setw(2) << segment << ".evt";
+		unique_ptr<FILE, int (*)(FILE*)> file(fopen(name.str().c_str(), "rb"), fclose);
+		if (!file) break;
+		segments.push_back(name.str());
+	}
+	return segments;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,75 @@
+/**
+ * This header file contains the classes that stream raw NSCLDAQ event files
+ * into the analysis without a SpecTcl pass. A single reader thread walks the
+ * ring items of each run's .evt segments and copies the bodies of physics
+ * events into batches; analysis threads take whole batches from a bounded
+ * queue, so reading overlaps with analysis and memory use stays fixed.
+ *
+ * Ring items follow the NSCLDAQ 11/12 layout: uint32 size in bytes (including
+ * itself), uint32 type, uint32 body header size, then the body. A body header
+ * size of 0 (NSCLDAQ 11) or 4 (NSCLDAQ 12) means there is no body header.
+ */
+
+#ifndef RawPipeline_H
+#define RawPipeline_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A block of consecutive physics events from one run
+struct RawBatch {
+	int run = -1;
+	long long firstEntry = 0; // index of the first event among the run's physics events
+	std::vector<uint16_t> words; // event bodies, back to back
+	std::vector<size_t> offsets{0}; // event i is words[offsets[i]] to words[offsets[i + 1]]
+
+	size_t Size() const { return offsets.size() - 1; }
+	uint16_t* Event(size_t i) { return words.data() + offsets[i]; }
+	size_t EventWords(size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+	void clear() {
+		words.clear();
+		offsets.assign(1, 0);
+	}
+};
+
+class RawPipeline {
+
+public:
+	// capacity is the number of batches that may wait in the queue,
+	// batchSize the number of events per batch
+	RawPipeline(size_t capacity, size_t batchSize);
+
+	// Reader side: read every segment of a run in order, then call Close()
+	// once all runs have been read. Returns the number of physics events.
+	size_t ReadRun(const std::vector<std::string>& segments, int run);
+	void Close();
+
+	// Analysis side: wait for the next batch, false once the queue is closed and empty
+	bool Pop(RawBatch& batch);
+
+	// Segments of a run named run-NNNN-SS.evt in dir, in order
+	static std::vector<std::string> FindSegments(const std::string& dir, int run);
+
+	static const uint32_t PhysicsEvent = 30; // NSCLDAQ PHYSICS_EVENT ring item type
+
+private:
+	size_t capacity;
+	size_t batchSize;
+
+	std::mutex mutex;
+	std::condition_variable notFull;
+	std::condition_variable notEmpty;
+	std::deque<RawBatch> queue;
+	bool closed{false};
+
+	void Push(RawBatch& batch);
+
+};
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * This implementation file contains the RawUnpacker class, see RawUnpacker.h
+ * for the layout of the event body.
+ */
+
+#include "RawUnpacker.h"
+
+#include <cmath>
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RawUnpacker::RawUnpacker() {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool RawUnpacker::Unpack(uint16_t* body, size_t nwords, Input::GobbiInput& gobbi, Input::TexNeutInput& texneut, Input::QDCInput& qdc, Input::TDCInput& tdc) {
+	if (nwords < 2) return false;
+	size_t size = Word32(body);
+	if (size < 2 || size > nwords) return false;
+	const uint16_t* end = body + size;
+	uint16_t* point = body + 2;
+
+	// Silicon, via the HINP4 unpacker. The packet length word counts the words
+	// after it, so the next packet starts right after those. A channel read
+	// twice means a corrupt packet, the event is dropped.
+	uint16_t* packet = point;
+	if (packet >= end || packet + 1 + *packet > end) return false;
+	if (!Si.unpackSi_HINP4(point, end)) return false;
+	uint64_t seen[(HINP_NCOLUMNS + 63) / 64] = {0};
+	for (int i = 0; i < Si.NstripsRead; i++) {
+		if (Si.board[i] < 1 || Si.board[i] > HINP_BOARD_COUNT || Si.chan[i] >= HINP_CHAN_COUNT) continue;
+		if (Si.high[i] == 0 || Si.high[i] >= 16384) continue;
+		size_t id = (Si.board[i] - 1) * HINP_CHAN_COUNT + Si.chan[i];
+		if (seen[id / 64] & (1ull << (id % 64))) return false;
+		seen[id / 64] |= 1ull << (id % 64);
+		if (!gobbi.Add(Si.board[i], Si.chan[i], Si.high[i], Si.low[i], Si.time[i])) return false;
+	}
+	point = packet + 1 + *packet;
+
+	if (!UnpackPSD(point, end, texneut)) return false;
+	if (!UnpackQDC(point, end, qdc)) return false;
+	return UnpackTDC(point, end, tdc);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Same framing as HINP::unpackSi_HINP4: word 0 is the length, word 1 the
+// marker, words 2-3 NWords, word 4 the number of data words, words 5-8 are
+// skipped and the hits start at word 9. The hits must fit in the packet's own
+// length word, not just in the event, or they would run into the QDC block.
+bool RawUnpacker::UnpackPSD(uint16_t*& point, const uint16_t* end, Input::TexNeutInput& texneut) {
+	const int wordsPerHit = 5;
+	const int headerWords = 9;
+	uint16_t* packet = point;
+	if (packet + headerWords > end || packet + 1 + *packet > end) return false;
+	if (packet[1] != psdMarker) return false;
+
+	int ndata = packet[4];
+	if (ndata % wordsPerHit != 0) return false;
+	if (headerWords + ndata > 1 + *packet) return false;
+	const uint16_t* hit = packet + headerWords;
+
+	// A channel read twice means a corrupt packet, the event is dropped
+	uint64_t seen[(PSD_NCOLUMNS + 63) / 64] = {0};
+	for (int k = 0; k < ndata / wordsPerHit; k++, hit += wordsPerHit) {
+		size_t chip = (hit[0] & 0x1FE0) >> 5;
+		size_t chan = hit[0] & 0x1F;
+		if (chip < 1 || chip > PSD_CHIP_COUNT || chan >= PSD_CHAN_COUNT) continue;
+		if (hit[4] == 0 || hit[4] >= 16384) continue;
+		size_t id = (chip - 1) * PSD_CHAN_COUNT + chan;
+		if (seen[id / 64] & (1ull << (id % 64))) return false;
+		seen[id / 64] |= 1ull << (id % 64);
+		if (!texneut.Add(chip, chan, hit[1], hit[2], hit[3], hit[4])) return false;
+	}
+	point = packet + 1 + *packet;
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// CAEN V965: bits 26-24 give the word type (2 header, 0 datum, 4 end of block,
+// 6 not valid). A datum holds the channel in bits 20-17, the range in bit 16
+// (1 = low range), underflow/overflow in bits 13/12 and the value in bits 11-0.
+bool RawUnpacker::UnpackQDC(uint16_t*& point, const uint16_t* end, Input::QDCInput& qdc) {
+	size_t high[QDC_CHAN_COUNT] = {0};
+	size_t low[QDC_CHAN_COUNT] = {0};
+
+	while (point + 2 <= end) {
+		uint32_t word = Word32(point);
+		point += 2;
+		uint32_t type = (word >> 24) & 0x7;
+		if (type == 4 || type == 6) break;
+		if (type != 0) continue;
+
+		size_t chan = (word >> 17) & 0xF;
+		if (chan >= QDC_CHAN_COUNT || (word & 0x3000)) continue;
+		if (word & 0x10000) low[chan] = word & 0xFFF;
+		else high[chan] = word & 0xFFF;
+	}
+
+	for (size_t i = 0; i < QDC_CHAN_COUNT; i++)
+		if (high[i] != 0) qdc.Add(i, high[i], low[i]);
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// CAEN V1190A: bits 31-27 give the word type (8 global header, 1 TDC header,
+// 0 measurement, 3 TDC trailer, 4 TDC error, 17 trigger time tag, 16 global
+// trailer, 24 filler). A measurement holds the trailing-edge flag in bit 26,
+// the channel in bits 25-19 and the time in bits 18-0. Times are converted to
+// ns relative to the first hit in channel 0, which is what SpecTcl stores.
+bool RawUnpacker::UnpackTDC(uint16_t*& point, const uint16_t* end, Input::TDCInput& tdc) {
+	uint32_t raw[TDC_CHAN_COUNT][TDC_HIT_COUNT];
+	size_t nraw[TDC_CHAN_COUNT] = {0};
+
+	while (point + 2 <= end) {
+		uint32_t word = Word32(point);
+		point += 2;
+		uint32_t type = word >> 27;
+		if (type == 16) break;
+		if (type != 0 || (word & (1u << 26))) continue;
+
+		size_t chan = (word >> 19) & 0x7F;
+		if (chan >= TDC_CHAN_COUNT || nraw[chan] >= TDC_HIT_COUNT) continue;
+		raw[chan][nraw[chan]++] = word & 0x7FFFF;
+	}
+
+	// No reference time, the event cannot be used
+	if (nraw[0] == 0) return false;
+
+	double ref = raw[0][0];
+	for (size_t ch = 0; ch < TDC_CHAN_COUNT; ch++) {
+		for (size_t hit = 0; hit < nraw[ch]; hit++) {
+			double t = (raw[ch][hit] - ref) * TDC_LSB_NS;
+			if (abs(t) >= 10000) continue;
+			tdc.Add(ch, t);
+		}
+	}
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
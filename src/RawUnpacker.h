@@ -0,0 +1,50 @@
+/**
+ * This header file contains the RawUnpacker class, which unpacks the body of
+ * a raw NSCLDAQ physics event straight into the hit buffers of Input, doing
+ * the work SpecTcl otherwise does before the sort. The body is a sequence of
+ * 16-bit words laid out as the readout writes it:
+ *
+ *   uint32  event size in 16-bit words, including itself
+ *   XLM packet of the Gobbi HINP boards, unpacked by HINP::unpackSi_HINP4
+ *   XLM packet of the TexNeut PSD chips, same framing, 5 words per hit
+ *           (id, A, B, C, T)
+ *   CAEN V965 QDC block (header, data words, end of block)
+ *   CAEN V1190A TDC block (global header ... global trailer)
+ *
+ * 32-bit CAEN words are stored low half first. Make sure the markers and the
+ * defines in Input.h match the readout of your hardware system!
+ */
+
+#ifndef RawUnpacker_H
+#define RawUnpacker_H
+
+#include "HINP.h"
+#include "Input.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class RawUnpacker {
+
+public:
+	RawUnpacker();
+
+	// Fill the hit buffers from one event body, false if the event is malformed
+	// (packets overrunning the event, a channel read twice, more hits than the
+	// buffers hold) or has no TDC reference hit (the SpecTcl path drops those
+	// events too)
+	bool Unpack(uint16_t* body, size_t nwords, Input::GobbiInput&, Input::TexNeutInput&, Input::QDCInput&, Input::TDCInput&);
+
+	HINP Si;                       // HINP4 unpacker for the silicon boards
+	unsigned short psdMarker = 0x1ff1; // XLM marker of the PSD motherboard
+
+private:
+	bool UnpackPSD(uint16_t*& point, const uint16_t* end, Input::TexNeutInput&);
+	bool UnpackQDC(uint16_t*& point, const uint16_t* end, Input::QDCInput&);
+	bool UnpackTDC(uint16_t*& point, const uint16_t* end, Input::TDCInput&);
+
+	static uint32_t Word32(const uint16_t* point) { return point[0] | ((uint32_t)point[1] << 16); }
+
+};
+
+#endif
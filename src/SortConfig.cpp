@@ -9,6 +9,7 @@
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include <stuffing.hpp>
 
@@ -16,7 +17,7 @@ using namespace std;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-SortConfig::SortConfig(string configFilePath) {
+SortConfig::SortConfig(string configFilePath) : pidCache("none"), pidMode("gates"), pidLossSuffix("Si"), pidCutWidth(0.3), calTables(false), calDither(false), scheduler("run"), nthreads(4), numaNode(-1), pinThreads(false), inputMode("reader"), writeIndex(false) {
 	cout << "Reading sort code config file..." << endl;
 
 	// Open config file, check that it exists	
@@ -40,10 +41,43 @@ SortConfig::SortConfig(string configFilePath) {
 			lossDir = line.substr(line.find('=') + 2);
 		else if (line.find("PIDDir") != string::npos)
 			PIDDir = line.substr(line.find('=') + 2);
+		else if (line.find("pidCache") != string::npos)
+			pidCache = line.substr(line.find('=') + 2);
+		else if (line.find("pidMode") != string::npos) {
+			pidMode = line.substr(line.find('=') + 2);
+			if (pidMode != "gates" && pidMode != "linear")
+				throw invalid_argument("pidMode in config file " + configFilePath + " must be either \"gates\" or \"linear\"");
+		}
+		else if (line.find("pidLossSuffix") != string::npos)
+			pidLossSuffix = line.substr(line.find('=') + 2);
+		else if (line.find("pidDeltaThick") != string::npos) {
+			stringstream values(line.substr(line.find('=') + 2));
+			string value;
+			try {
+				while (getline(values, value, ','))
+					pidDeltaThick.push_back(stof(value));
+			}
+			catch (...) {
+				throw invalid_argument("pidDeltaThick in config file " + configFilePath + " is not a comma-separated list of floats");
+			}
+		}
+		else if (line.find("pidCutWidth") != string::npos) {
+			string temps = line.substr(line.find('=') + 2);
+			try {
+				pidCutWidth = stof(temps);
+			}
+			catch (...) {
+				throw invalid_argument("pidCutWidth in config file " + configFilePath + " is not a valid float");
+			}
+		}
 		else if (line.find("targetSuffix") != string::npos)
 			targetSuffix = line.substr(line.find('=') + 2);
 		else if (line.find("calDir") != string::npos)
 			calDir = line.substr(line.find('=') + 2);
+		else if (line.find("channelMapFile") != string::npos)
+			channelMapFile = line.substr(line.find('=') + 2);
+		else if (line.find("calDBFile") != string::npos)
+			calDBFile = line.substr(line.find('=') + 2);
 		else if (line.find("frontEcalFile") != string::npos)
 			frontEcalFile = line.substr(line.find('=') + 2);
 		else if (line.find("backEcalFile") != string::npos)
@@ -58,6 +92,14 @@ SortConfig::SortConfig(string configFilePath) {
 			backTimecalFile = line.substr(line.find('=') + 2);
 		else if (line.find("deltaTimecalFile") != string::npos)
 			deltaTimecalFile = line.substr(line.find('=') + 2);
+		else if (line.find("calTables") != string::npos) {
+			string temps = line.substr(line.find('=') + 2);
+			calTables = (temps == "true" || temps == "1");
+		}
+		else if (line.find("calDither") != string::npos) {
+			string temps = line.substr(line.find('=') + 2);
+			calDither = (temps == "true" || temps == "1");
+		}
 		else if (line.find("targdist") != string::npos) {
 			string temps = line.substr(line.find('=') + 2);
 			try {
@@ -85,8 +127,71 @@ SortConfig::SortConfig(string configFilePath) {
 				throw invalid_argument("targthick in config file " + configFilePath + " is not a valid size_t (unsigned integer)");
 			}
 		}
+		else if (line.find("nthreads") != string::npos) {
+			string temps = line.substr(line.find('=') + 2);
+			try {
+				if (temps.empty() || temps[0] == '-') throw invalid_argument(temps); // stoul would wrap negative values
+				nthreads = stoul(temps);
+			}
+			catch (...) {
+				throw invalid_argument("nthreads in config file " + configFilePath + " is not a valid size_t (unsigned integer)");
+			}
+		}
+		else if (line.find("cpuList") != string::npos) {
+			cpuList = line.substr(line.find('=') + 2);
+			if (cpuList == "all") cpuList = "";
+		}
+		else if (line.find("numaNode") != string::npos) {
+			string temps = line.substr(line.find('=') + 2);
+			try {
+				numaNode = stoi(temps);
+			}
+			catch (...) {
+				throw invalid_argument("numaNode in config file " + configFilePath + " is not a valid int");
+			}
+		}
+		else if (line.find("pinThreads") != string::npos) {
+			string temps = line.substr(line.find('=') + 2);
+			pinThreads = (temps == "true" || temps == "1");
+		}
+		else if (line.find("inputMode") != string::npos)
+			inputMode = line.substr(line.find('=') + 2);
+		else if (line.find("hitListDir") != string::npos)
+			hitListDir = line.substr(line.find('=') + 2);
+		else if (line.find("writeIndex") != string::npos) {
+			string temps = line.substr(line.find('=') + 2);
+			writeIndex = (temps == "true" || temps == "1");
+		}
+		else if (line.find("rawDataDir") != string::npos)
+			rawDataDir = line.substr(line.find('=') + 2);
+		else if (line.find("indexDir") != string::npos)
+			indexDir = line.substr(line.find('=') + 2);
+		else if (line.find("indexSelect") != string::npos) {
+			indexSelect = line.substr(line.find('=') + 2);
+			if (indexSelect == "none") indexSelect = "";
+		}
+		else if (line.find("spectraFile") != string::npos)
+			spectraFile = line.substr(line.find('=') + 2);
+		else if (line.find("disableSpectra") != string::npos) {
+			stringstream patterns(line.substr(line.find('=') + 2));
+			string pattern;
+			while (getline(patterns, pattern, ','))
+				if (!pattern.empty() && pattern != "none") disableSpectra.push_back(pattern);
+		}
+		else if (line.find("scheduler") != string::npos) {
+			scheduler = line.substr(line.find('=') + 2);
+			if (scheduler != "run" && scheduler != "global")
+				throw invalid_argument("scheduler in config file " + configFilePath + " must be either \"run\" or \"global\"");
+		}
 	}
 	configfile.close();
+
+	// Without the database the diamond is not calibrated and the TDC shifts are 0,
+	// so running without it has to be asked for
+	if (calDBFile.empty())
+		throw invalid_argument("calDBFile is missing from config file " + configFilePath + ", give the calibration database (normally ../config/calibrations.config) or none");
+	if (channelMapFile.empty())
+		throw invalid_argument("channelMapFile is missing from config file " + configFilePath + ", give the HINP channel map (normally ../config/channelmap.config)");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
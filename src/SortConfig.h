@@ -8,6 +8,7 @@
 #define SortConfig_H
 
 #include <string>
+#include <vector>
 
 class SortConfig {
 private:
@@ -18,8 +19,15 @@ private:
 	std::string otreeName;
 	std::string lossDir;
 	std::string PIDDir;
+	std::string pidCache;
+	std::string pidMode;
+	std::string pidLossSuffix;
+	std::vector<float> pidDeltaThick;
+	float pidCutWidth;
 	std::string targetSuffix;
 	std::string calDir;
+	std::string channelMapFile;
+	std::string calDBFile;
 	std::string frontEcalFile;
 	std::string backEcalFile;
 	std::string deltaEcalFile;
@@ -27,9 +35,24 @@ private:
 	std::string frontTimecalFile;
 	std::string backTimecalFile;
 	std::string deltaTimecalFile;
+	bool calTables;
+	bool calDither;
 	float targdist;
 	float targthick;
 	size_t updateRate;
+	std::string scheduler;
+	size_t nthreads;
+	std::string cpuList;
+	int numaNode;
+	bool pinThreads;
+	std::string inputMode;
+	std::string hitListDir;
+	bool writeIndex;
+	std::string indexDir;
+	std::string indexSelect;
+	std::string rawDataDir;
+	std::string spectraFile;
+	std::vector<std::string> disableSpectra;
 
 public:
 	SortConfig(std::string configFilePath);
@@ -42,8 +65,15 @@ public:
 	std::string GetOtreeName() const { return otreeName; }
 	std::string GetLossDir() const { return lossDir; }
 	std::string GetPIDDir() const { return PIDDir; }
+	std::string GetPIDCache() const { return pidCache; } // "none" to read the zline files directly
+	bool IsLinearPID() const { return pidMode == "linear"; }
+	std::string GetPIDLossSuffix() const { return pidLossSuffix; }
+	const std::vector<float>& GetPIDDeltaThick() const { return pidDeltaThick; }
+	float GetPIDCutWidth() const { return pidCutWidth; }
 	std::string GetTargetSuffix() const { return targetSuffix; }
 	std::string GetCalDir() const { return calDir; }
+	std::string GetChannelMapFile() const { return channelMapFile; }
+	std::string GetCalDBFile() const { return calDBFile; } // "none" to use the files below for every run
 	std::string GetFrontEcalFile() const { return frontEcalFile; }
 	std::string GetBackEcalFile() const { return backEcalFile; }
 	std::string GetDeltaEcalFile() const { return deltaEcalFile; }
@@ -51,9 +81,33 @@ public:
 	std::string GetFrontTimecalFile() const { return frontTimecalFile; }
 	std::string GetBackTimecalFile() const { return backTimecalFile; }
 	std::string GetDeltaTimecalFile() const { return deltaTimecalFile; }
+	bool GetCalTables() const { return calTables; }
+	bool GetCalDither() const { return calDither; }
 	float GetTargDist() const { return targdist; }
 	float GetTargThick() const { return targthick; }
 	size_t GetUpdateRate() const { return updateRate; }
+	std::string GetScheduler() const { return scheduler; }
+	bool IsGlobalScheduler() const { return scheduler == "global"; }
+	size_t GetNThreads() const { return nthreads; }
+	std::string GetCPUList() const { return cpuList; }
+	int GetNumaNode() const { return numaNode; }
+	bool GetPinThreads() const { return pinThreads; }
+	std::string GetInputMode() const { return inputMode; }
+	std::string GetHitListDir() const { return hitListDir; }
+	bool GetWriteIndex() const { return writeIndex; }
+	std::string GetIndexDir() const { return indexDir; }
+	std::string GetIndexSelect() const { return indexSelect; }
+	std::string GetRawDataDir() const { return rawDataDir; }
+	std::string GetSpectraFile() const { return spectraFile; }
+	const std::vector<std::string>& GetDisableSpectra() const { return disableSpectra; }
+
+	// Setters for command-line overrides
+	void SetNThreads(size_t n) { nthreads = n; }
+	void SetCPUList(const std::string& list) { cpuList = list; }
+	void SetNumaNode(int node) { numaNode = node; }
+	void SetPinThreads(bool pin) { pinThreads = pin; }
+	void SetWriteIndex(bool write) { writeIndex = write; }
+	void SetIndexSelect(const std::string& select) { indexSelect = select; }
 };
 
 #endif
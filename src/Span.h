@@ -0,0 +1,32 @@
+/**
+ * This header file contains Span, a minimal read-only view of a contiguous
+ * array (pointer plus length), used to hand the per-event hit buffers of
+ * Input to consumers without copying them. It can be replaced by std::span
+ * once the code moves to C++20.
+ */
+
+#ifndef Span_H
+#define Span_H
+
+#include <cstddef>
+
+template <typename T>
+class Span {
+
+public:
+	Span(const T* data, size_t size) : ptr(data), len(size) {}
+
+	const T* data() const { return ptr; }
+	size_t size() const { return len; }
+	bool empty() const { return len == 0; }
+	const T& operator[](size_t i) const { return ptr[i]; }
+	const T* begin() const { return ptr; }
+	const T* end() const { return ptr + len; }
+
+private:
+	const T* ptr;
+	size_t len;
+
+};
+
+#endif
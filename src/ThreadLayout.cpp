@@ -0,0 +1,207 @@
+/**
+ * This implementation file contains the ThreadLayout class, which decides how
+ * many worker threads the sort code uses and which CPUs (and NUMA node) they
+ * are allowed to run on. CPU and NUMA information is read from the Linux
+ * scheduler and sysfs, so no external NUMA library is needed.
+ */
+
+#include "ThreadLayout.h"
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <stuffing.hpp>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ThreadLayout::ThreadLayout(size_t nthreads0, const string& cpuList, int numaNode0, bool pinThreads0) : nthreads(nthreads0), numaNode(numaNode0), pinThreads(pinThreads0) {
+	vector<int> available = GetAvailableCPUs();
+
+	// Start from the explicit CPU list if one was given, keeping its order
+	if (cpuList.empty()) cpus = available;
+	else {
+		for (int cpu : ParseCPUList(cpuList)) {
+			if (find(available.begin(), available.end(), cpu) != available.end())
+				cpus.push_back(cpu);
+			else
+				cerr << "CPU " << cpu << " from cpu list is not available to this process, skipping" << endl;
+		}
+	}
+
+	// Keep only the CPUs that belong to the requested NUMA node
+	if (numaNode >= 0) {
+		vector<int> nodeCPUs = GetNumaNodeCPUs(numaNode);
+		if (nodeCPUs.empty()) throw invalid_argument(string(BOLDRED) + string("NUMA node ") + to_string(numaNode) + string(" does not exist or has no CPUs") + string(RESET));
+		vector<int> selected;
+		for (int cpu : cpus)
+			if (find(nodeCPUs.begin(), nodeCPUs.end(), cpu) != nodeCPUs.end()) selected.push_back(cpu);
+		cpus = selected;
+	}
+
+	if (cpus.empty()) throw invalid_argument(string(BOLDRED) + string("No usable CPUs left after applying cpu list and NUMA node settings") + string(RESET));
+
+	// More workers than CPUs only adds contention
+	if (nthreads == 0) nthreads = cpus.size();
+	else if (nthreads > cpus.size()) {
+		cerr << nthreads << " worker threads requested but only " << cpus.size() << " CPUs selected, using " << cpus.size() << endl;
+		nthreads = cpus.size();
+	}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ThreadLayout::Apply() const {
+#ifdef __linux__
+	// Threads inherit the affinity mask and memory policy of the thread that
+	// creates them, so setting both here covers the ROOT/TBB worker pool
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu : cpus) CPU_SET(cpu, &set);
+	if (sched_setaffinity(0, sizeof(set), &set) != 0)
+		cerr << "Failed to set CPU affinity, continuing without it" << endl;
+
+	if (numaNode >= 0) {
+		// Node mask as an array of words covering every node on the host. The
+		// kernel reads one bit less than maxnode, hence the + 1
+		const size_t bitsPerWord = 8 * sizeof(unsigned long);
+		const size_t nodes = max(GetNumaNodeCount(), numaNode + 1);
+		vector<unsigned long> nodemask((nodes + bitsPerWord - 1) / bitsPerWord, 0);
+		nodemask[numaNode / bitsPerWord] |= 1UL << (numaNode % bitsPerWord);
+		if (syscall(SYS_set_mempolicy, MPOL_BIND, nodemask.data(), nodemask.size() * bitsPerWord + 1) != 0)
+			cerr << "Failed to bind memory to NUMA node " << numaNode << ", continuing without it" << endl;
+	}
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ThreadLayout::PinCurrentThread() {
+	if (!pinThreads) return;
+	thread_local bool pinned = false;
+	if (pinned) return;
+	pinned = true;
+
+#ifdef __linux__
+	int cpu = cpus[nextSlot.fetch_add(1) % cpus.size()];
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ThreadLayout::Report(ostream& out) const {
+	out << "Thread layout:" << endl;
+	out << "  CPUs available to process: " << FormatCPUList(GetAvailableCPUs()) << endl;
+	out << "  NUMA nodes on host:        " << GetNumaNodeCount() << endl;
+	out << "  NUMA node binding:         " << (numaNode >= 0 ? to_string(numaNode) : string("none")) << endl;
+	out << "  Selected CPUs:             " << FormatCPUList(cpus) << " (" << cpus.size() << ")" << endl;
+	out << "  Worker threads:            " << nthreads << endl;
+	out << "  Per-worker pinning:        " << (pinThreads ? "on" : "off") << endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+vector<int> ThreadLayout::ParseCPUList(const string& list) {
+#ifdef __linux__
+	const int maxCPU = CPU_SETSIZE;
+#else
+	const int maxCPU = 1024;
+#endif
+	vector<int> result;
+	stringstream ss(list);
+	string item;
+	while (getline(ss, item, ',')) {
+		if (item.empty()) continue;
+		int first, last;
+		bool valid;
+		try {
+			size_t dash = item.find('-');
+			size_t pos;
+			first = stoi(item.substr(0, dash), &pos);
+			valid = pos == min(dash, item.size());
+			if (dash == string::npos) last = first;
+			else {
+				last = stoi(item.substr(dash + 1), &pos);
+				valid = valid && pos == item.size() - dash - 1;
+			}
+		}
+		catch (...) {
+			valid = false;
+		}
+		if (!valid) throw invalid_argument(string(BOLDRED) + string("Invalid entry '") + item + string("' in CPU list ") + list + string(RESET));
+		if (first < 0 || first > last || last >= maxCPU)
+			throw invalid_argument(string(BOLDRED) + string("Entry '") + item + string("' in CPU list ") + list + string(" must be ascending CPU numbers below ") + to_string(maxCPU) + string(RESET));
+
+		// A CPU listed twice would count twice towards the thread count
+		for (int cpu = first; cpu <= last; cpu++)
+			if (find(result.begin(), result.end(), cpu) == result.end()) result.push_back(cpu);
+	}
+	return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+vector<int> ThreadLayout::GetAvailableCPUs() {
+	vector<int> result;
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &set)) result.push_back(cpu);
+	}
+#endif
+	if (result.empty()) result.push_back(0);
+	return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+vector<int> ThreadLayout::GetNumaNodeCPUs(int node) {
+	ifstream file("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+	if (file.fail()) return {};
+	string list;
+	getline(file, list);
+	return ParseCPUList(list);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int ThreadLayout::GetNumaNodeCount() {
+	int count = 0;
+	while (ifstream("/sys/devices/system/node/node" + to_string(count) + "/cpulist").good()) count++;
+	return max(count, 1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+string ThreadLayout::FormatCPUList(const vector<int>& list) {
+	ostringstream out;
+	for (size_t i = 0; i < list.size(); i++) {
+		size_t j = i;
+		while (j + 1 < list.size() && list[j + 1] == list[j] + 1) j++;
+		if (i > 0) out << ",";
+		out << list[i];
+		if (j > i) out << "-" << list[j];
+		i = j;
+	}
+	return out.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
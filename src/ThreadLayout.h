@@ -0,0 +1,59 @@
+/**
+ * This header file contains the ThreadLayout class, which decides how many
+ * worker threads the sort code uses and which CPUs (and NUMA node) they are
+ * allowed to run on. The layout is built from the sort.config settings and
+ * any command-line overrides, and is applied once before implicit
+ * multi-threading is enabled. Individual workers can then pin themselves to
+ * a single CPU of the layout with PinCurrentThread().
+ */
+
+#ifndef ThreadLayout_H
+#define ThreadLayout_H
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ThreadLayout {
+
+public:
+	// nthreads = 0 uses one thread per selected CPU, an empty cpuList selects
+	// all CPUs available to the process and numaNode < 0 disables NUMA binding
+	ThreadLayout(size_t nthreads, const std::string& cpuList, int numaNode, bool pinThreads);
+
+	// Restrict the process (and so every thread created afterwards) to the
+	// selected CPUs and NUMA node memory. Call before ROOT::EnableImplicitMT.
+	void Apply() const;
+
+	// Pin the calling thread to the next CPU of the layout. Only the first call
+	// from each thread does anything, so this is cheap to call once per task.
+	void PinCurrentThread();
+
+	// Print the chosen topology
+	void Report(std::ostream&) const;
+
+	size_t GetNThreads() const { return nthreads; }
+	const std::vector<int>& GetCPUs() const { return cpus; }
+	int GetNumaNode() const { return numaNode; }
+	bool GetPinThreads() const { return pinThreads; }
+
+	// Parse a Linux-style CPU list such as "0-7,16,18-19", without duplicates.
+	// Throws on reversed ranges and CPUs at or above CPU_SETSIZE
+	static std::vector<int> ParseCPUList(const std::string&);
+
+private:
+	size_t nthreads;
+	std::vector<int> cpus; // CPUs selected for the workers, in pinning order
+	int numaNode;
+	bool pinThreads;
+	std::atomic<size_t> nextSlot{0};
+
+	static std::vector<int> GetAvailableCPUs();
+	static std::vector<int> GetNumaNodeCPUs(int node);
+	static int GetNumaNodeCount();
+	static std::string FormatCPUList(const std::vector<int>&);
+
+};
+
+#endif
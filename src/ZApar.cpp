@@ -4,7 +4,7 @@
  * constructor reads in a banana gate
 \param ifile is an ifstream object of an open file containing gate
 */
-ZApar::ZApar(std::ifstream& ifile)
+ZApar::ZApar(std::ifstream& ifile) : owner(true)
 {
   ifile >> Z >> A;
   mass = (float)A;
@@ -18,12 +18,22 @@ ZApar::ZApar(std::ifstream& ifile)
     //cout<<i << " "  << x[i] << " " << y[i] << endl;
   }
 }
+//*****************************************
+  /**
+   * constructor for a gate whose points are kept elsewhere (e.g. the
+   * memory-mapped gate cache), the points are not copied or freed
+   */
+ZApar::ZApar(int Z0, int A0, int n0, const float* x0, const float* y0)
+  : Z(Z0), mass((float)A0), A(A0), n(n0), x((float*)x0), y((float*)y0), owner(false)
+{
+}
 //*****************************************
   /**
    * destructor
    */
  ZApar::~ZApar()
 {
+  if (!owner) return;
   delete [] x;
   delete [] y;
 }
@@ -33,7 +43,7 @@ ZApar::ZApar(std::ifstream& ifile)
 \param xx is energy of particle
 \param yy is energy loss of particle
   */
-bool ZApar::inBanana(float xx, float yy)
+bool ZApar::inBanana(float xx, float yy) const
 {
   if (TMath::IsInside(xx,yy,n,x,y)) return true;
   else return false; 
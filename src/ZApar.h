@@ -17,12 +17,14 @@ class ZApar
   int A; //!< mass number of particle
 
   ZApar(std::ifstream & ifile);
-  ZApar(){};
+  ZApar(int Z0, int A0, int n0, const float* x0, const float* y0);
+  ZApar() : owner(false) {};
   ~ZApar();
-  bool inBanana(float x, float y);
+  bool inBanana(float x, float y) const;
 
   int n; //!<number of points
   float *x; //!<pointer to x array
   float *y; //!<pointer to y array
+  bool owner; //!<true if x and y were allocated here
 };
 #endif
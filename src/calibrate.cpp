@@ -17,14 +17,15 @@ calibrate::calibrate(int Ntele0, int Nstrip0, string name, int order0, bool weav
   Nstrip = Nstrip0;
   Ntele = Ntele0;
   order = order0;
+  table = nullptr;
+  tableChannels = 0;
 
   //cout << Nstrip << " " << name << endl;
 
-  Coeff = new coeff*[Ntele];
-  for (int i=0;i<Ntele;i++)
-  {
-    Coeff[i] = new coeff [Nstrip];
-  }
+  slope.assign(Ntele*Nstrip, 0.);
+  intercept.assign(Ntele*Nstrip, 0.);
+  a2.assign(Ntele*Nstrip, 0.);
+  a3.assign(Ntele*Nstrip, 0.);
 
   ifstream file(name);
 	if (file.fail()) throw invalid_argument(string(BOLDRED) + string("Calibration file ") + name + string(" does not exist or failed to open") + string(RESET));
@@ -36,11 +37,11 @@ calibrate::calibrate(int Ntele0, int Nstrip0, string name, int order0, bool weav
 
   int itele,istrip;
   int board,chan;
-  float slope, intercept, a2,a3;
+  float s, b, c2, c3;
   for(;;)
   {
-    file >>  itele >> istrip >> slope >> intercept;
-    //cout << itele << " " << istrip << " " << slope << " " << intercept <<endl;
+    file >>  itele >> istrip >> s >> b;
+    //cout << itele << " " << istrip << " " << s << " " << b <<endl;
 
     if (weave)
     {
@@ -61,17 +62,20 @@ calibrate::calibrate(int Ntele0, int Nstrip0, string name, int order0, bool weav
     }
     //cout << "Board# " << board << " new chip# " << chan << endl;
 
-    if (order >=2) file >> a2;
-    else a2 = 0.;
-    if (order == 3) file >> a3;
-    else a3 = 0.;
+    if (order >=2) file >> c2;
+    else c2 = 0.;
+    if (order == 3) file >> c3;
+    else c3 = 0.;
     if (file.eof()) break;
     if (file.bad()) break;
 
-    Coeff[itele][chan].slope = slope;
-    Coeff[itele][chan].intercept = intercept;
-    Coeff[itele][chan].a2 = a2;
-    Coeff[itele][chan].a3 = a3;
+    if (itele < 0 || itele >= Ntele || chan < 0 || chan >= Nstrip)
+      throw invalid_argument(string(BOLDRED) + string("Calibration file ") + name + string(" has an entry for telescope ") + to_string(itele) + string(" strip ") + to_string(chan) + string(" which does not exist") + string(RESET));
+    int k = itele*Nstrip + chan;
+    slope[k] = s;
+    intercept[k] = b;
+    a2[k] = c2;
+    a3[k] = c3;
   }
   file.close();
   file.clear();  
@@ -83,12 +87,29 @@ calibrate::calibrate(int Ntele0, int Nstrip0, string name, int order0, bool weav
    */
 calibrate::~calibrate()
 {
-  for (int i=0;i<Ntele;i++)
+  delete [] table;
+}
+//*****************************************
+  /**
+   * expands the calibration of every strip into a table of energies
+   * for raw values 0 to nchannels-1, so getEnergy is a single load 
+   * for those values. One more value is stored per strip for 
+   * interpolating when a fraction of a channel is added.
+\param nchannels - number of raw values of the ADC
+  */
+void calibrate::BuildTable(int nchannels)
+{
+  delete [] table;
+  tableChannels = nchannels;
+  table = new float [Ntele*Nstrip*(nchannels+1)];
+  float * entry = table;
+  for (int itele=0;itele<Ntele;itele++)
   {
-    delete [] Coeff[i];
+    for (int istrip=0;istrip<Nstrip;istrip++)
+    {
+      for (int ich=0;ich<=nchannels;ich++) *entry++ = polynomial(itele*Nstrip+istrip,ich);
+    }
   }
-
-  delete [] Coeff;
 }
 //*****************************************
   /**
@@ -96,25 +117,109 @@ calibrate::~calibrate()
 \param istrip - number of the strip or detector
 \param channel - raw channels from the ADC, etc
   */
-float calibrate::getEnergy(int itele,int istrip,float channel)
+float calibrate::getEnergy(int itele,int istrip,float channel) const
+{
+  return energy(itele*Nstrip+istrip,channel);
+}
+//*****************************************
+  /**
+   * returns the calibrated energy of a raw value plus a fraction of a 
+   * channel, used to dither the ADC values. With a table the energy is
+   * interpolated between the two channels.
+\param istrip - number of the strip or detector
+\param channel - raw channels from the ADC, etc
+\param fraction - between 0 and 1
+  */
+float calibrate::getEnergy(int itele,int istrip,int channel,float fraction) const
+{
+  return energy(itele*Nstrip+istrip,channel,fraction);
+}
+//*****************************************
+float calibrate::energy(int k,float channel) const
 {
-  float fact = channel*Coeff[itele][istrip].slope + Coeff[itele][istrip].intercept;
+  if (table && channel >= 0 && channel < tableChannels)
+  {
+    int ich = channel;
+    if (ich == channel) return table[k*(tableChannels+1)+ich];
+  }
+  return polynomial(k,channel);
+}
+//*****************************************
+float calibrate::energy(int k,int channel,float fraction) const
+{
+  if (table && channel >= 0 && channel < tableChannels)
+  {
+    const float * entry = table + k*(tableChannels+1) + channel;
+    return entry[0] + fraction*(entry[1]-entry[0]);
+  }
+  return polynomial(k,channel+fraction);
+}
+//*****************************************
+float calibrate::polynomial(int k,float channel) const
+{
+  float fact = channel*slope[k] + intercept[k];
   if (order == 1) return fact;
 
-  fact += pow(channel,2)*Coeff[itele][istrip].a2;
+  // same as pow(channel,2) and pow(channel,3) in double precision
+  double channel2 = (double)channel*channel;
+  fact += channel2*a2[k];
   if (order == 2) return fact;
-  if (order == 3)return pow(channel,3)*Coeff[itele][istrip].a3 + fact;
+  if (order == 3)return channel2*channel*a3[k] + fact;
   else abort();
 }
 
-float calibrate::getTime(int itele,int istrip,float channel)
+float calibrate::getTime(int itele,int istrip,float channel) const
 {
-  return channel + Coeff[itele][istrip].intercept;
+  return channel + intercept[itele*Nstrip+istrip];
 }
 
 
-float calibrate::reverseCal(int itele, int istrip, float energy)
+float calibrate::reverseCal(int itele, int istrip, float energy) const
 {
-  float fact = (energy - Coeff[itele][istrip].intercept)/Coeff[itele][istrip].slope;
+  int k = itele*Nstrip + istrip;
+  float fact = (energy - intercept[k])/slope[k];
   return fact;
 }
+//*****************************************
+  /**
+   * calibrates a list of hits, giving the same energies as getEnergy 
+   * for each hit. Without a table, linear calibrations are done in a 
+   * single loop over the hits that the compiler can vectorize.
+\param index - itele*Nstrip+istrip of each hit
+\param channel - raw value of each hit
+\param fraction - fraction of a channel to add to each hit, or nullptr
+\param out - filled with one energy per hit
+  */
+void calibrate::getEnergy(Span<uint16_t> index, Span<uint32_t> channel, const float* fraction, float* out) const
+{
+  size_t n = channel.size();
+  if (table || order != 1)
+  {
+    for (size_t i=0;i<n;i++)
+    {
+      if (fraction) out[i] = energy(index[i],(int)channel[i],fraction[i]);
+      else out[i] = energy(index[i],(float)channel[i]);
+    }
+    return;
+  }
+
+  const float * s = slope.data();
+  const float * b = intercept.data();
+  if (fraction)
+  {
+    for (size_t i=0;i<n;i++) out[i] = ((float)channel[i] + fraction[i])*s[index[i]] + b[index[i]];
+    return;
+  }
+  for (size_t i=0;i<n;i++) out[i] = (float)channel[i]*s[index[i]] + b[index[i]];
+}
+//*****************************************
+  /**
+   * times of a list of hits, same as getTime for each hit
+\param index - itele*Nstrip+istrip of each hit
+  */
+void calibrate::getTime(Span<uint16_t> index, Span<uint32_t> channel, float* out) const
+{
+  size_t n = channel.size();
+  const float * b = intercept.data();
+  for (size_t i=0;i<n;i++) out[i] = (float)channel[i] + b[index[i]];
+}
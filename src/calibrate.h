@@ -4,31 +4,44 @@
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include "Span.h"
 using namespace std;
 
-/**
- * storge of calibration coefficients
- */
-struct coeff
-{
-  float slope; //!< slope for calibration
-  float intercept; //!< intercept for calibration
-  float a2;  //!< quadratic coeff if needed
-  float a3; //!< cubic coeff if needed
-};
-
 class calibrate
 {
  public:
   calibrate(int Ntele,int Nstrip,string file,int order,bool weave);
   ~calibrate();
-  float getEnergy(int itele,int istrip,float channel);
-  float getTime(int itele,int istrip,float channel);
-  float reverseCal(int itele, int istrip, float energy);
+  float getEnergy(int itele,int istrip,float channel) const;
+  float getEnergy(int itele,int istrip,int channel,float fraction) const;
+  float getTime(int itele,int istrip,float channel) const;
+  float reverseCal(int itele, int istrip, float energy) const;
+
+  //calibrate a list of hits in one pass, each given by its strip index
+  //itele*Nstrip+istrip. fraction can be nullptr
+  void getEnergy(Span<uint16_t> index, Span<uint32_t> channel, const float* fraction, float* energy) const;
+  void getTime(Span<uint16_t> index, Span<uint32_t> channel, float* time) const;
+
   int order;
   int Nstrip;  //!< number of strips
   int Ntele;   //!<number of telescopes
-  coeff ** Coeff;  //!< array with calibration coefficients for each strip
+
+  //calibration coefficients, one entry per strip at itele*Nstrip+istrip
+  vector<float> slope; //!< slope for calibration
+  vector<float> intercept; //!< intercept for calibration
+  vector<float> a2;  //!< quadratic coeff if needed
+  vector<float> a3; //!< cubic coeff if needed
+
+  void BuildTable(int nchannels);
+  float * table; //!< energy of every raw value of each strip, or nullptr
+  int tableChannels; //!< raw values 0 to tableChannels-1 are in the table
+
+ private:
+  float energy(int k,float channel) const;
+  float energy(int k,int channel,float fraction) const;
+  float polynomial(int k,float channel) const;
 
 };
 #endif
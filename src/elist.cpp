@@ -2,50 +2,71 @@
 
 #include "elist.h"
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 using namespace std;
 
 //***********************************************************************
-//places a new strip energy in an order list from max to min energy
+//appends a new strip energy to the list, Sort() puts it in order
 //updated for high/low gain (HINP4) chips
 void elist::Add(int StripNum, float energy, int energyRlow, int energyR, float time)
 {
+  if (Nstore == nnn) return; // not enougth room in list 
 
-  //first find place in list
-  int i = 0;
-  for (;;)
+  order & o = Order[Nstore];
+  o.energy = energy;
+  o.energyR = energyR;
+  o.energyRlow = energyRlow;
+  o.energylow = 0;
+  o.energyMax = 0;
+  o.strip = StripNum;
+  o.neighbours = 0;
+  o.time = time;
+
+  // increase list length
+  Nstore++;
+  mult = Nstore;
+}
+//***********************************************************************
+//puts the list in order from max to min energy (from max to min raw 
+//energy for strips without a calibrated energy). Strips with the same
+//energy stay in the order they were added.
+void elist::Sort()
+{
+  if (Nstore <= 1) return;
+
+  // Each strip gets one 64 bit key whose ascending order is the list
+  // order: strips with a calibrated energy first, then the energy
+  // in descending order, then the position in the list, so the keys 
+  // are all different and the sort is stable.
+  unsigned long long key[nnn];
+  for (int i=0;i<Nstore;i++)
   {
-    if (i == Nstore) break;
-    if(energy >0)
-    {
-      if (energy > Order[i].energy) break;
-    }
-    else
+    bool raw = !(Order[i].energy > 0);
+    float value = raw ? Order[i].energyR : Order[i].energy;
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = (bits & 0x80000000u) ? bits : ~bits & 0x7fffffffu; // descending
+    key[i] = ((unsigned long long)raw << 38) | ((unsigned long long)bits << 6) | i;
+  }
+
+  // insertion sort, the lists are short and usually close to in order
+  for (int i=1;i<Nstore;i++)
+  {
+    unsigned long long k = key[i];
+    if (key[i-1] < k) continue;
+    order o = Order[i];
+    int j = i;
+    for (;j>0 && key[j-1] > k;j--) 
     {
-      if(energyR > Order[i].energyR) break;
+      key[j] = key[j-1];
+      Order[j] = Order[j-1];
     }
-    i++;
+    key[j] = k;
+    Order[j] = o;
   }
-  if (i == nnn) return; // not enougth room in list 
-
-  //new list length
-  int N = min(nnn,Nstore+1);
-
-  // move those in energy below the new value down the list 
-  for (int j=N-1;j>i;j--) Order[j] = Order[j-1];
-
-  //add present energy to list
-  Order[i].energy = energy;
-  Order[i].energyR = energyR;
-  Order[i].energyRlow = energyRlow;
-  Order[i].strip = StripNum;
-  Order[i].time = time;
-
-  // increase list length
-  Nstore = N;
-  mult = N;
 }
-
+//***********************************************************************
 void elist::Remove(int entry)
 {
   if (entry >= Nstore)
@@ -68,11 +89,15 @@ void elist::Remove(int entry)
 
 void elist::Add(int StripNum, float energy, int rawenergy, int time)  //for use with tree
 {
+  if (Nstore == nnn) return;
   Order[Nstore].energy = energy;
   Order[Nstore].strip = StripNum;
   Order[Nstore].time = time;
   Order[Nstore].energylow = 0;
   Order[Nstore].energyR = rawenergy;
+  Order[Nstore].energyRlow = 0;
+  Order[Nstore].energyMax = 0;
+  Order[Nstore].neighbours = 0;
   Nstore++;
 }
 
@@ -134,16 +159,7 @@ int elist::Reduce(const char*face)
 //*********************************************************************
 void elist::reset()
 {
-  for(int i =0;i<Nstore;i++)
-  {
-    Order[i].energy = 0;
-    Order[i].energyR = 0;
-    Order[i].energyRlow = 0;
-    Order[i].strip = 0;
-    Order[i].time = 0;
-    Order[i].neighbours=0;
-    Order[i].energyMax=0;
-  }
+  // Add() fills every field, so old entries need not be cleared
   Nstore = 0;
   mult = 0;
   
@@ -167,37 +183,96 @@ void elist::Neighbours(int id)
     Order[0].neighbours = 0;
     return ;
   }
-  int i=-1;
-  for (;;)
-  {
-    i++;
-    if (i >= Nstore) break;
-    Order[i].energyMax = Order[i].energy;
-    Order[i].neighbours = 0;
 
-    int j = i;
-    for (;;)
+  //strips added back to another strip are taken off the live mask and
+  //the list is compacted once at the end
+  unsigned long long all = (1ULL << Nstore) - 1; //nnn < 64
+  unsigned long long live = all;
+  if (Nstore <= 8 || !StripNeighbours(live)) 
+  {
+    //same search by list position, quicker for a few strips and used 
+    //for repeated or out of range strips
+    for (int i=0;i<Nstore;i++)
     {
-      j++;
-      if (j >= Nstore) break;
-      if (abs(Order[i].strip - Order[j].strip) == 1) //neighboring strips
-      {
-
-        //cout << "!!!!!  neighbour addback " << endl;
-        Order[i].energy += Order[j].energy; // add energy from adjacent strip
-        Order[i].neighbours++;
+      if (!(live >> i & 1)) continue;
+      Order[i].energyMax = Order[i].energy;
+      Order[i].neighbours = 0;
 
-        //remove this strip from the list
-        if (j != Nstore-1)
+      //look at the strips still in the list after this one
+      for (unsigned long long rest = live & ~((2ULL << i) - 1); rest; rest &= rest - 1)
+      {
+        int j = __builtin_ctzll(rest);
+        if (abs(Order[i].strip - Order[j].strip) == 1) //neighboring strips
         {
-          //shift all Order objects back one
-          for (int k=j+1;k<Nstore;k++) {Order[k-1] = Order[k];}
+          Order[i].energy += Order[j].energy; // add energy from adjacent strip
+          Order[i].neighbours++;
+          live &= ~(1ULL << j);
         }
-        Nstore--;
-        j--;
       }
     }
   }
+  if (live == all) return;
+
+  //remove the added back strips from the list
+  int N = 0;
+  for (int i=0;i<Nstore;i++)
+  {
+    if (!(live >> i & 1)) continue;
+    if (N != i) Order[N] = Order[i];
+    N++;
+  }
+  Nstore = N;
+}
+
+//*********************************************************************
+//neighbour addback using a strip occupancy mask and the energy of each
+//strip. Going down the list, each strip still there takes in the strips 
+//on either side of it, which are necessarily lower in the list, so the 
+//loop has no data dependent branches. Clears the list positions of the 
+//added back strips in live. Returns false, doing nothing, if a strip is
+//out of range or repeated.
+bool elist::StripNeighbours(unsigned long long & live)
+{
+  //indexed by strip+1, so both sides of strips 0 and 61 exist. Only
+  //the entries next to a strip in the list are ever read.
+  unsigned long long occupied = 0; // bit per strip+1
+  float stripE[64];
+  unsigned char slot[64];          // list position of each strip
+  for (int i=0;i<Nstore;i++)
+  {
+    unsigned int bit = Order[i].strip + 1;
+    if (bit - 1 >= 62) return false;
+    stripE[bit-1] = stripE[bit+1] = 0;
+    slot[bit-1] = slot[bit+1] = 0;
+  }
+  for (int i=0;i<Nstore;i++)
+  {
+    unsigned int bit = Order[i].strip + 1;
+    if (occupied >> bit & 1) return false;
+    occupied |= 1ULL << bit;
+    stripE[bit] = Order[i].energy;
+    slot[bit] = i;
+  }
+
+  for (int i=0;i<Nstore;i++)
+  {
+    int bit = Order[i].strip + 1;
+    unsigned long long there = -(occupied >> bit & 1); // not added back yet
+    unsigned long long low = (occupied >> (bit-1) & 1) & there;
+    unsigned long long high = (occupied >> (bit+1) & 1) & there;
+    occupied &= ~(low << (bit-1) | high << (bit+1));
+
+    //add the two sides in list order
+    float Elow = stripE[bit-1] * low;
+    float Ehigh = stripE[bit+1] * high;
+    bool lowFirst = slot[bit-1] < slot[bit+1];
+    Order[i].energyMax = Order[i].energy;
+    Order[i].energy += lowFirst ? Elow : Ehigh;
+    Order[i].energy += lowFirst ? Ehigh : Elow;
+    Order[i].neighbours = low + high;
+    live &= ~(low << slot[bit-1] | high << slot[bit+1]);
+  }
+  return true;
 }
 
 //cut threshold
@@ -23,7 +23,9 @@ int const nnn=60;
  *
  * This class creates an energy ordered list of the strips
  * read out from a strip detector, keeping track of the strip 
- * numbers that fired.
+ * numbers that fired. Strips are appended as they are unpacked
+ * and the list is put in order once by Sort(), after all the
+ * strips of the event have been added.
  */
 
 class elist
@@ -35,11 +37,15 @@ class elist
 
   void Add(int,float,int,int,float);
   void Add(int, float, int, int);
+  void Sort();
   void Remove(int);
   int  Reduce(const char*);
   void reset();
   void Neighbours(int);
   void Threshold(float);
   float threshold0;
+
+ private:
+  bool StripNeighbours(unsigned long long &);
 };
 #endif
@@ -14,127 +14,50 @@ histo::histo(shared_ptr<ROOT::TBufferMergerFile> f, event& texneutevent) : texne
 	tpar = new TTree("tpar", "tpar");
 	tpar->Branch("texneut", &texneutout);
 
-  //// Create subdirectories to store arrays of spectra
-  
-	// TexNeut directory
-  dirTexNeut = new TDirectoryFile("TexNeut", "TexNeut");
-
-	// Directory for summary plots
-  dirSummary = new TDirectoryFile("Summary", "Summary"); // name, title
-
-  // Energies, Raw+Calibrated
-  dir1dFrontE_R = dirSummary->mkdir("1dFrontE_R","1dFrontE_R");
-  dir1dBackE_R  = dirSummary->mkdir("1dBackE_R","1dBackE_R");
-  dir1dDeltaE_R = dirSummary->mkdir("1dDeltaE_R","1dDeltaE_R");
-
-  dir1dFrontlowE_R = dirSummary->mkdir("1dFrontlowE_R","1dFrontlowE_R");
-  dir1dBacklowE_R  = dirSummary->mkdir("1dBacklowE_R","1dBacklowE_R");
-  dir1dDeltalowE_R = dirSummary->mkdir("1dDeltalowE_R","1dDeltalowE_R");
-
-  dir1dFrontE_cal = dirSummary->mkdir("1dFrontE_cal","1dFrontE_cal");
-  dir1dBackE_cal  = dirSummary->mkdir("1dBackE_cal","1dBackE_cal");
-  dir1dDeltaE_cal = dirSummary->mkdir("1dDeltaE_cal","1dDeltaE_cal");
-
-  dirAngleCorrFrontE = dirSummary->mkdir("AngleCorrFrontE","AngleCorrFrontE");
-  dirAngleCorrDeltaE = dirSummary->mkdir("AngleCorrDeltaE","AngleCorrDeltaE");
-
-  // Delta Energies, Raw+Calibrated
-  dir1dFrontTime_R = dirSummary->mkdir("1dFrontTime_R","1dFrontTime_R");
-  dir1dBackTime_R  = dirSummary->mkdir("1dBackTime_R","1dBackTime_R");
-  dir1dDeltaTime_R = dirSummary->mkdir("1dDeltaTime_R","1dDeltaTime_R");
-
-	//Directory for diamond detector
-  dirDiamond = new TDirectoryFile("dirDiamond", "dirDiamond"); // name, title
-
-	//Directory for diamond detector
-  dirTDC = new TDirectoryFile("dirTDC", "dirTDC"); // name, title
-
-  // Directory for DeltaE-E plots
-  dirDEEplots = new TDirectoryFile("DEEplots","DEEplots");
-  dirhitmaps  = new TDirectoryFile("hitmaps","hitmaps");
-
-  // Directory for all correlations and inv-mass
-  dirInvMass = new TDirectoryFile("InvMass","InvMass");
-  dir4He = dirInvMass->mkdir("4He","4He");
-  dir5He = dirInvMass->mkdir("5He","5He");
-  dir6He = dirInvMass->mkdir("6He","6He");
-  dir5Li = dirInvMass->mkdir("5Li","5Li");
-  dir6Li = dirInvMass->mkdir("6Li","6Li");
-  dir7Li = dirInvMass->mkdir("7Li","7Li");
-  dir6Be = dirInvMass->mkdir("6Be","6Be");
-  dir7Be = dirInvMass->mkdir("7Be","7Be");
-  dir8Be = dirInvMass->mkdir("8Be","8Be");
-  dir9B  = dirInvMass->mkdir("9B","9B");
-
-	dirTexNeut->cd();
+	// Bind the spectrum handles. Binning and directories are declared in the
+	// spectra file (see HistStore.h), spectra missing from it are not filled.
 
 	// TexNeut histograms  
-  topDownMap = new TH2I("topDownMap","",16,0,16,6,0,6);
-  barZeroFingers = new TH2I("barZeroFingers","",1024,0,8192,1024,0,8192);
-	neutron_mult = new TH1I("neutron_mult","",10,0.5,10.5);
-
-  dirSummary->cd();
-
-  int Nbin         = 5000;
-  float Ecal_Emax  = 50.0;
-  float Delta_Emax = 16.0;
+  topDownMap = H2("topDownMap");
+  barZeroFingers = H2("barZeroFingers");
+	neutron_mult = H1("neutron_mult");
 
   //// Create full summaries
 
   // Energies, Raw+Calibrated
-  sumFrontE_R = new TH2I("sumFrontE_R","",4*channum,0,4*channum,1024,0,8192);
-  sumFrontE_R->SetOption("colz");
-  sumBackE_R = new TH2I("sumBackE_R","",4*channum,0,4*channum,1024,0,8192);
-  sumBackE_R->SetOption("colz");
-  sumDeltaE_R = new TH2I("sumDeltaE_R","",4*channum,0,4*channum,1024,0,8192);
-  sumDeltaE_R->SetOption("colz");
-  sumFrontE_cal = new TH2I("sumFrontE_cal","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  sumFrontE_cal->SetOption("colz");
-  sumFrontE_addback = new TH2I("sumFrontE_addback","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  sumFrontE_addback->SetOption("colz");
-
-  sumBackE_cal = new TH2I("sumBackE_cal","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  sumBackE_cal->SetOption("colz");
-  sumBackE_addback = new TH2I("sumBackE_addback","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  sumBackE_addback->SetOption("colz");
-  sumDeltaE_cal = new TH2I("sumDeltaE_cal","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  sumDeltaE_cal->SetOption("colz");
-  sumDeltaE_addback = new TH2I("sumDeltaE_addback","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  sumDeltaE_addback->SetOption("colz");
-
-  sumEtot_cal = new TH2I("sumEtot_cal","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  sumEtot_cal->SetOption("colz");
-  AngleCorrSum_cal = new TH2I("AngleCorrSum_cal","",4*channum,0,4*channum,Nbin,0,Ecal_Emax);
-  AngleCorrSum_cal->SetOption("colz");
-
-  AngleCorrFrontE_cal = new TH2I("AngleCorrFrontE_cal","",4*channum,0,4*channum,Nbin/4,0,Ecal_Emax);
-  AngleCorrFrontE_cal->SetOption("colz");
-  AngleCorrDeltaE_cal = new TH2I("AngleCorrDeltaE_cal","",4*channum,0,4*channum,Nbin/4,0,Delta_Emax);
-  AngleCorrDeltaE_cal->SetOption("colz");
+  sumFrontE_R = H2("sumFrontE_R");
+  sumBackE_R = H2("sumBackE_R");
+  sumDeltaE_R = H2("sumDeltaE_R");
+  sumFrontE_cal = H2("sumFrontE_cal");
+  sumFrontE_addback = H2("sumFrontE_addback");
+
+  sumBackE_cal = H2("sumBackE_cal");
+  sumBackE_addback = H2("sumBackE_addback");
+  sumDeltaE_cal = H2("sumDeltaE_cal");
+  sumDeltaE_addback = H2("sumDeltaE_addback");
+
+  sumEtot_cal = H2("sumEtot_cal");
+  AngleCorrSum_cal = H2("AngleCorrSum_cal");
+
+  AngleCorrFrontE_cal = H2("AngleCorrFrontE_cal");
+  AngleCorrDeltaE_cal = H2("AngleCorrDeltaE_cal");
 
   // Times
-  sumFrontTime_R = new TH2I("sumFrontTime_R","",4*channum,0,4*channum,512,0,16383);
-  sumFrontTime_R->SetOption("colz");
-  sumFrontTime_cal = new TH2I("sumFrontTime_cal","",4*channum,0,4*channum,512,0,16383);
-  sumFrontTime_cal->SetOption("colz");
-  sumBackTime_R = new TH2I("sumBackTime_R","",4*channum,0,4*channum,512,0,16383);
-  sumBackTime_R->SetOption("colz");
-  sumBackTime_cal = new TH2I("sumBackTime_cal","",4*channum,0,4*channum,512,0,16383);
-  sumBackTime_cal->SetOption("colz");
-  sumDeltaTime_R = new TH2I("sumDeltaTime_R","",4*channum,0,4*channum,512,0,16383);
-  sumDeltaTime_R->SetOption("colz");
-  sumDeltaTime_cal = new TH2I("sumDeltaTime_cal","",4*channum,0,4*channum,512,0,16383);
-  sumDeltaTime_cal->SetOption("colz");
-
-  sumFrontTimeMult1_cal = new TH2I("sumFrontTimeMult1_cal","",4*channum,0,4*channum,512,0,16383);
-  sumFrontTimeMult1_cal->SetOption("colz");
+  sumFrontTime_R = H2("sumFrontTime_R");
+  sumFrontTime_cal = H2("sumFrontTime_cal");
+  sumBackTime_R = H2("sumBackTime_R");
+  sumBackTime_cal = H2("sumBackTime_cal");
+  sumDeltaTime_R = H2("sumDeltaTime_R");
+  sumDeltaTime_cal = H2("sumDeltaTime_cal");
+
+  sumFrontTimeMult1_cal = H2("sumFrontTimeMult1_cal");
 
   ostringstream name;
-  //FrontvsBack = new TH2I("FrontvsBack","",500,0,20,500,0,20);
+  //FrontvsBack = H2("FrontvsBack");
   for (int i=0;i<4;i++) {
   	name.str("");
   	name << "FrontvsBack_" << i;
-  	FrontvsBack[i] = new TH2I(name.str().c_str(),"",500,0,80,500,0,80);
+  	FrontvsBack[i] = H2(name.str().c_str());
   }
 
 
@@ -143,453 +66,431 @@ histo::histo(shared_ptr<ROOT::TBufferMergerFile> f, event& texneutevent) : texne
     for (int chan_i = 0; chan_i < channum; chan_i++) {
 
       // Individual Front Energy
-      dir1dFrontE_R->cd();
       name.str("");
       name << "FrontE_R" << board_i << "_" << chan_i;
-      FrontE_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",2048,0,8192);
+      FrontE_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dFrontlowE_R->cd();
       name.str("");
       name << "FrontElow_R" << board_i << "_" << chan_i;
-      FrontElow_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",1024,0,4095);
+      FrontElow_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dFrontTime_R->cd();
       name.str("");
       name << "FrontTime_R" << board_i << "_" << chan_i;
-      FrontTime_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",1024,0,16383);
+      FrontTime_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dFrontE_cal->cd();
       name.str("");
       name << "FrontE_cal" << board_i << "_" << chan_i;
-      FrontE_cal[board_i][chan_i] = new TH1I(name.str().c_str(),"",Nbin,5,Ecal_Emax);
+      FrontE_cal[board_i][chan_i] = H1(name.str().c_str());
 
       // Individual Back Energy
-      dir1dBackE_R->cd();
       name.str("");
       name << "BackE_R" << board_i << "_" << chan_i;
-      BackE_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",2048,0,8192);
+      BackE_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dBacklowE_R->cd();
       name.str("");
       name << "BackElow_R" << board_i << "_" << chan_i;
-      BackElow_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",1024,0,4095);
+      BackElow_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dBackTime_R->cd();
       name.str("");
       name << "BackTime_R" << board_i << "_" << chan_i;
-      BackTime_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",1024,0,16383);
+      BackTime_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dBackE_cal->cd();
       name.str("");
       name << "BackE_cal" << board_i << "_" << chan_i;
-      BackE_cal[board_i][chan_i] = new TH1I(name.str().c_str(),"",Nbin,0,Ecal_Emax);
+      BackE_cal[board_i][chan_i] = H1(name.str().c_str());
 
       // Individual DeltaE
-      dir1dDeltaE_R->cd();
       name.str("");
       name << "DeltaE_R" << board_i << "_" << chan_i;
-      DeltaE_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",1024,0,4095);
+      DeltaE_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dDeltalowE_R->cd();
       name.str("");
       name << "DeltaElow_R" << board_i << "_" << chan_i;
-      DeltaElow_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",1024,0,4095);
+      DeltaElow_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dDeltaTime_R->cd();
       name.str("");
       name << "DeltaTime_R" << board_i << "_" << chan_i;
-      DeltaTime_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",1024,0,16383);
+      DeltaTime_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dir1dDeltaE_cal->cd();
       name.str("");
       name << "DeltaE_cal" << board_i << "_" << chan_i;
-      DeltaE_cal[board_i][chan_i] = new TH1I(name.str().c_str(),"",Nbin,0,Delta_Emax);
+      DeltaE_cal[board_i][chan_i] = H1(name.str().c_str());
 
-      dirAngleCorrFrontE->cd();
       name.str("");
       name << "AngleCorrFrontE" << board_i << "_" << chan_i;
-      AngleCorrE[board_i][chan_i] = new TH1I(name.str().c_str(),"",Nbin/3,5,Ecal_Emax);
+      AngleCorrE[board_i][chan_i] = H1(name.str().c_str());
 
-      dirAngleCorrDeltaE->cd();
       name.str("");
       name << "AngleCorrDeltaE" << board_i << "_" << chan_i;
-      AngleCorrDeltaE[board_i][chan_i] = new TH1I(name.str().c_str(),"",Nbin/3,0,Delta_Emax);
+      AngleCorrDeltaE[board_i][chan_i] = H1(name.str().c_str());
     }
   }
 
   for (int board_i = 0; board_i < E_boardnum / 2; board_i++) {
     for (int chan_i = 0; chan_i < channum; chan_i++) {
-      dirAngleCorrFrontE->cd();
       name.str("");
       name << "AngleCorrE_noCorr" << board_i << "_" << chan_i;
-      AngleCorr_noCorr[board_i][chan_i] = new TH1I(name.str().c_str(),"",Nbin/3,5,Ecal_Emax);
+      AngleCorr_noCorr[board_i][chan_i] = H1(name.str().c_str());
 
-      dirAngleCorrDeltaE->cd();
       name.str("");
       name << "AngleCorrDeltaE_noCorr" << board_i << "_" << chan_i;
-      AngleCorrDeltaE_noCorr[board_i][chan_i] = new TH1I(name.str().c_str(),"",Nbin/3,0,Delta_Emax);
+      AngleCorrDeltaE_noCorr[board_i][chan_i] = H1(name.str().c_str());
     }
   }
 
   for (int board_i = 0; board_i < E_boardnum / 2; board_i++) {
     for (int chan_i = 0; chan_i < channum; chan_i++) {
-      dirAngleCorrFrontE->cd();
       name.str("");
       name << "AngleCorrE_R" << board_i << "_" << chan_i;
-      AngleCorrE_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",2048,0,8192);
+      AngleCorrE_R[board_i][chan_i] = H1(name.str().c_str());
 
-      dirAngleCorrDeltaE->cd();
       name.str("");
       name << "AngleCorrDeltaE_R" << board_i << "_" << chan_i;
-      AngleCorrDeltaE_R[board_i][chan_i] = new TH1I(name.str().c_str(),"",2048,0,8192);
+      AngleCorrDeltaE_R[board_i][chan_i] = H1(name.str().c_str());
     }
   }
 
 	//Diamond detector plots
-	dirDiamond->cd();
-	DiamondQDC0 = new TH1I("DiamondQDC0","",1024,0,4192);
-	DiamondQDC0_cal = new TH1I("DiamondQDC0_cal","",625,0,25);
-	DiamondQDC1 = new TH1I("DiamondQDC1","",1024,0,4192);
-	DiamondQDC1_cal = new TH1I("DiamondQDC1_cal","",625,0,25);
+	DiamondQDC0 = H1("DiamondQDC0");
+	DiamondQDC0_cal = H1("DiamondQDC0_cal");
+	DiamondQDC1 = H1("DiamondQDC1");
+	DiamondQDC1_cal = H1("DiamondQDC1_cal");
 	
-	DiamondQDC0_tgate_orA = new TH1I("DiamondQDC0_tgate_orA","",1024,0,4192);
-	DiamondQDC0_tgate_orA_cal = new TH1I("DiamondQDC0_tgate_orA_cal","",625,0,25);	
+	DiamondQDC0_tgate_orA = H1("DiamondQDC0_tgate_orA");
+	DiamondQDC0_tgate_orA_cal = H1("DiamondQDC0_tgate_orA_cal");	
 
-	DiamondQDC0_vs_torA = new TH2I("DiamondQDC0_vs_torA","",1024,0,4192,1000,-500,500);
-	DiamondQDC0_vs_torA_cal = new TH2I("DiamondQDC0_vs_torA_cal","",625,0,25,1000,-500,500);
+	DiamondQDC0_vs_torA = H2("DiamondQDC0_vs_torA");
+	DiamondQDC0_vs_torA_cal = H2("DiamondQDC0_vs_torA_cal");
 	
 	for (int i=0;i<4;i++) {
 		name.str("");
 		name << "Diamond_vs_GobbiEsum_" << i;
-		Diamond_vs_GobbiEsum[i] = new TH2I(name.str().c_str(),"",500,0,80,1024,0,4192);
+		Diamond_vs_GobbiEsum[i] = H2(name.str().c_str());
 		
 		name.str("");
 		name << "Diamond_vs_GobbiEsum_cal_" << i;
-		Diamond_vs_GobbiEsum_cal[i] = new TH2I(name.str().c_str(),"",500,0,80,625,0,25);
+		Diamond_vs_GobbiEsum_cal[i] = H2(name.str().c_str());
 		
 		name.str("");
 		name << "Diamond_vs_GobbiEsum_torA_" << i;
-		Diamond_vs_GobbiEsum_torA[i] = new TH2I(name.str().c_str(),"",500,0,80,1024,0,4192);
+		Diamond_vs_GobbiEsum_torA[i] = H2(name.str().c_str());
 		
 		name.str("");
 		name << "Diamond_vs_GobbiEsum_torA_cal_" << i;
-		Diamond_vs_GobbiEsum_torA_cal[i] = new TH2I(name.str().c_str(),"",500,0,80,625,0,25);
+		Diamond_vs_GobbiEsum_torA_cal[i] = H2(name.str().c_str());
 	}
 	
 	//TDC plots
-	dirTDC->cd();
 	for (int i=0;i<16;i++) {
 		name.str("");
 		name << "TDCspect_" << i;
-		TDC_Plot[i] = new TH1I(name.str().c_str(),"",1000,-500,500);
+		TDC_Plot[i] = H1(name.str().c_str());
 
 		if (i > 3) {
 			name.str("");
 			name << "TDCspect_TN_shift" << i-4;
-			TDC_Plot_TN_shift[i-4] = new TH1I(name.str().c_str(),"",1000,-500,500);
+			TDC_Plot_TN_shift[i-4] = H1(name.str().c_str());
 		}
 	}
 	
-	TDC_sum = new TH2I("TDC_sum","",16,-0.5,15.5,1000,-500,500);
-	TDC_sum_TN = new TH2I("TDC_sum_TN","",12,-0.5,11.5,1000,-500,500);
-	TDC_sum_TN_shift = new TH2I("TDC_sum_TN_shift","",12,-0.5,11.5,1000,-500,500);
+	TDC_sum = H2("TDC_sum");
+	TDC_sum_TN = H2("TDC_sum_TN");
+	TDC_sum_TN_shift = H2("TDC_sum_TN_shift");
   // Create all spectra based on quadrants
-  dirDEEplots->cd();
   for (int quad = 0; quad < 4; quad++) {
     name.str("");
     name << "DEE_simple" << quad;
-    DEE_simple[quad] = new TH2I(name.str().c_str(),"",500,0,80,500,0,16); //E is x, DE is y
+    DEE_simple[quad] = H2(name.str().c_str()); //E is x, DE is y
 
     name.str("");
     name << "frontdeltastripnum_" << quad;
-    frontdeltastripnum[quad] = new TH2I(name.str().c_str(),"",32,-0.5,31.5,32,-0.5,31.5); //E is x, DE is y
+    frontdeltastripnum[quad] = H2(name.str().c_str()); //E is x, DE is y
 
     name.str("");
     name << "DEE" << quad;
-    DEE[quad] = new TH2I(name.str().c_str(),"",500,0,80,800,0,22); //E is x, DE is y
+    DEE[quad] = H2(name.str().c_str()); //E is x, DE is y
 
     name.str("");
     name << "timediff" << quad;   
-    timediff[quad] = new TH1I(name.str().c_str(),"",1000,-2000,2000);
+    timediff[quad] = H1(name.str().c_str());
+
+    name.str("");
+    name << "PIDlin" << quad;
+    PIDlin[quad] = H1(name.str().c_str());
+
+    name.str("");
+    name << "PIDlin_E" << quad;
+    PIDlin_E[quad] = H2(name.str().c_str()); //E is x, linear PID is y
   }
 
 
-  dirhitmaps->cd();
-  xyhitmap_allE = new TH2I("xyhitmap_allE","", 100,-10,10,100,-10,10);
-  xyhitmap = new TH2I("xyhitmap","", 100,-10,10,100,-10,10);
-  xyhitmap_EdEgate_1stEL = new TH2I("xyhitmap_EdEgate_1stEL","", 100,-10,10,100,-10,10);
-  xyhitmap_EdEgate_2ndEL = new TH2I("xyhitmap_EdEgate_2ndEL","", 100,-10,10,100,-10,10);
-  xyhitmap_tgate_orA = new TH2I("xyhitmap_tgate_orA","", 100,-10,10,100,-10,10);
-  protonhitmap = new TH2I("protonhitmap","", 100,-10,10,100,-10,10);
-  deuteronhitmap = new TH2I("deuteronhitmap","", 100,-10,10,100,-10,10);
-  tritonhitmap = new TH2I("tritonhitmap","", 100,-10,10,100,-10,10);
-  alphahitmap = new TH2I("alphahitmap","", 100,-10,10,100,-10,10);
-  He6hitmap = new TH2I("He6hitmap","", 100,-10,10,100,-10,10);
-  Lihitmap = new TH2I("Lihitmap","", 100,-10,10,100,-10,10);
-  LiVETOhitmap = new TH2I("LiVETOhitmap","", 100,-10,10,100,-10,10);
-
-  hitmapof_p = new TH2I("hitmapof_p","", 100,-10,10,100,-10,10);
-  hitmapof_6He = new TH2I("hitmapof_6He","", 100,-10,10,100,-10,10);
+  xyhitmap_allE = H2("xyhitmap_allE");
+  xyhitmap = H2("xyhitmap");
+  xyhitmap_EdEgate_1stEL = H2("xyhitmap_EdEgate_1stEL");
+  xyhitmap_EdEgate_2ndEL = H2("xyhitmap_EdEgate_2ndEL");
+  xyhitmap_tgate_orA = H2("xyhitmap_tgate_orA");
+  protonhitmap = H2("protonhitmap");
+  deuteronhitmap = H2("deuteronhitmap");
+  tritonhitmap = H2("tritonhitmap");
+  alphahitmap = H2("alphahitmap");
+  He6hitmap = H2("He6hitmap");
+  Lihitmap = H2("Lihitmap");
+  LiVETOhitmap = H2("LiVETOhitmap");
+
+  hitmapof_p = H2("hitmapof_p");
+  hitmapof_6He = H2("hitmapof_6He");
   
- 	xyhitmap_DiamondELlow = new TH2I("xyhitmap_DiamondELlow","", 100,-10,10,100,-10,10);
-  xyhitmap_DiamondELpeak = new TH2I("xyhitmap_DiamondELpeak","", 100,-10,10,100,-10,10);
- 	xyhitmap_DiamondELhigh = new TH2I("xyhitmap_DiamondELhigh","", 100,-10,10,100,-10,10);
+ 	xyhitmap_DiamondELlow = H2("xyhitmap_DiamondELlow");
+  xyhitmap_DiamondELpeak = H2("xyhitmap_DiamondELpeak");
+ 	xyhitmap_DiamondELhigh = H2("xyhitmap_DiamondELhigh");
 
-  Evstheta[0] = new TH2I("Evstheta0","",50,0,25,Nbin,0,Ecal_Emax);
-  Evstheta[1] = new TH2I("Evstheta1","",50,0,25,Nbin,0,Ecal_Emax);
-  Evstheta[2] = new TH2I("Evstheta2","",50,0,25,Nbin,0,Ecal_Emax);
-  Evstheta[3] = new TH2I("Evstheta3","",50,0,25,Nbin,0,Ecal_Emax);
-  Evstheta_all = new TH2I("Evstheta_all","",50,0,25,Nbin,0,Ecal_Emax);
-  Theta = new TH1I("Theta","",50,0,25);
+  Evstheta[0] = H2("Evstheta0");
+  Evstheta[1] = H2("Evstheta1");
+  Evstheta[2] = H2("Evstheta2");
+  Evstheta[3] = H2("Evstheta3");
+  Evstheta_all = H2("Evstheta_all");
+  Theta = H1("Theta");
 
-  ProtonEnergy = new TH2I("ProtonEnergy","",50,0,25,50,0,25);
+  ProtonEnergy = H2("ProtonEnergy");
 
-  dTime_proton = new TH1I("dTime_proton","",1500,-4000,2000);
-  dTime_deuteron = new TH1I("dTime_deuteron","",1500,-4000,2000);
-  dTime_triton = new TH1I("dTime_triton","",1500,-4000,2000);
-  dTime_alpha = new TH1I("dTime_alpha","",1500,-4000,2000);
-  dTime_He6 = new TH1I("dTime_He6","",1500,-4000,2000);
-  dTime_Li = new TH1I("dTime_Li","",1500,-4000,2000);
+  dTime_proton = H1("dTime_proton");
+  dTime_deuteron = H1("dTime_deuteron");
+  dTime_triton = H1("dTime_triton");
+  dTime_alpha = H1("dTime_alpha");
+  dTime_He6 = H1("dTime_He6");
+  dTime_Li = H1("dTime_Li");
 
-  CorrelationTable = new TH2I("CorrelationTable","",9,-0.5,8.5,9,0,8.5);
+  CorrelationTable = H2("CorrelationTable");
 
 
   // He4
-  dir4He->cd();
-  Erel_4He_pt = new TH1I("Erel_4He_pt","",800,0,30);
-  Ex_4He_pt = new TH1I("Ex_4He_pt","",350,19,26);
-  ThetaCM_4He_pt = new TH1I("ThetaCM_4He_pt","",200,0,10);
-  VCM_4He_pt = new TH1I("VCM_4He_pt","",100,0,14);
-
-  He4_p_hitmap = new TH2I("He4_p_hitmap","", 100,-10,10,100,-10,10);
-  He4_t_hitmap = new TH2I("He4_t_hitmap","", 100,-10,10,100,-10,10);
-  DEE_He4[0] = new TH2I("DEE_He4_quad0","",500,0,80,800,0,22); //E is x, DE is y
-  DEE_He4[1] = new TH2I("DEE_He4_quad1","",500,0,80,800,0,22); //E is x, DE is y
-  DEE_He4[2] = new TH2I("DEE_He4_quad2","",500,0,80,800,0,22); //E is x, DE is y
-  DEE_He4[3] = new TH2I("DEE_He4_quad3","",500,0,80,800,0,22); //E is x, DE is y
-  Erel_pt_costhetaH = new TH2I("Erel_pt_costhetaH","",200,0,8,25,-1,1);
-
-  Erel_4He_dd = new TH1I("Erel_4He_dd","",800,0,30);
-  Ex_4He_dd = new TH1I("Ex_4He_dd","",350,19,26);
-  ThetaCM_4He_dd = new TH1I("ThetaCM_4He_dd","",200,0,10);
-  VCM_4He_dd = new TH1I("VCM_4He_dd","",100,0,14);
-  Erel_dd_costhetaH = new TH2I("Erel_dd_costhetaH","",50,0,2,25,-1,1);
+  Erel_4He_pt = H1("Erel_4He_pt");
+  Ex_4He_pt = H1("Ex_4He_pt");
+  ThetaCM_4He_pt = H1("ThetaCM_4He_pt");
+  VCM_4He_pt = H1("VCM_4He_pt");
+
+  He4_p_hitmap = H2("He4_p_hitmap");
+  He4_t_hitmap = H2("He4_t_hitmap");
+  DEE_He4[0] = H2("DEE_He4_quad0"); //E is x, DE is y
+  DEE_He4[1] = H2("DEE_He4_quad1"); //E is x, DE is y
+  DEE_He4[2] = H2("DEE_He4_quad2"); //E is x, DE is y
+  DEE_He4[3] = H2("DEE_He4_quad3"); //E is x, DE is y
+  Erel_pt_costhetaH = H2("Erel_pt_costhetaH");
+
+  Erel_4He_dd = H1("Erel_4He_dd");
+  Ex_4He_dd = H1("Ex_4He_dd");
+  ThetaCM_4He_dd = H1("ThetaCM_4He_dd");
+  VCM_4He_dd = H1("VCM_4He_dd");
+  Erel_dd_costhetaH = H2("Erel_dd_costhetaH");
 
   // He5
-  dir5He->cd();
-  Erel_5He_dt = new TH1I("Erel_5He_dt","",800,0,30);
-  Ex_5He_dt = new TH1I("Ex_5He_dt","",800,-2,30);
-  ThetaCM_5He_dt = new TH1I("ThetaCM_5He_dt","",200,0,10);
-  VCM_5He_dt = new TH1I("VCM_5He_dt","",100,0,14);
+  Erel_5He_dt = H1("Erel_5He_dt");
+  Ex_5He_dt = H1("Ex_5He_dt");
+  ThetaCM_5He_dt = H1("ThetaCM_5He_dt");
+  VCM_5He_dt = H1("VCM_5He_dt");
 
   // He6
-  dir6He->cd();
-  Erel_6He_tt = new TH1I("Erel_6He_tt","",800,0,30);
-  Ex_6He_tt = new TH1I("Ex_6He_tt","",800,-2,30);
-  ThetaCM_6He_tt = new TH1I("ThetaCM_6He_tt","",200,0,10);
-  VCM_6He_tt = new TH1I("VCM_6He_tt","",100,0,14);
+  Erel_6He_tt = H1("Erel_6He_tt");
+  Ex_6He_tt = H1("Ex_6He_tt");
+  ThetaCM_6He_tt = H1("ThetaCM_6He_tt");
+  VCM_6He_tt = H1("VCM_6He_tt");
 
   // Li5
-  dir5Li->cd();
-  Erel_5Li_pa = new TH1I("Erel_5Li_pa","",800,0,30);
-  Ex_5Li_pa = new TH1I("Ex_5Li_pa","",800,-2,30);
-  ThetaCM_5Li_pa = new TH1I("ThetaCM_5Li_pa","",200,0,10);
-  VCM_5Li_pa = new TH1I("VCM_5Li_pa","",100,0,14);
+  Erel_5Li_pa = H1("Erel_5Li_pa");
+  Ex_5Li_pa = H1("Ex_5Li_pa");
+  ThetaCM_5Li_pa = H1("ThetaCM_5Li_pa");
+  VCM_5Li_pa = H1("VCM_5Li_pa");
 
-  Erel_5Li_d3He = new TH1I("Erel_5Li_d3He","",800,0,30);
-  Ex_5Li_d3He = new TH1I("Ex_5Li_d3He","",800,-2,30);
-  ThetaCM_5Li_d3He = new TH1I("ThetaCM_5Li_d3He","",200,0,10);
-  VCM_5Li_d3He = new TH1I("VCM_5Li_d3He","",100,0,14);
+  Erel_5Li_d3He = H1("Erel_5Li_d3He");
+  Ex_5Li_d3He = H1("Ex_5Li_d3He");
+  ThetaCM_5Li_d3He = H1("ThetaCM_5Li_d3He");
+  VCM_5Li_d3He = H1("VCM_5Li_d3He");
 
   // Li6
-  dir6Li->cd();
   // -> p + n + a
-  Erel_6Li_npa = new TH1I("Erel_6Li_npa","",500,0,5);
-  Ex_6Li_npa_trans = new TH1I("Ex_6Li_npa_trans","",500,0,5);
-  Ex_6Li_npa_long = new TH1I("Ex_6Li_npa_long","",500,0,5);
-  Ex_6Li_npa = new TH1I("Ex_6Li_npa","",500,0,5);
-  cos_thetaH_npa = new TH1I("cos_thetaH_npa","",100,-1.1,1.1);
-  ThetaCM_6Li_npa = new TH1I("ThetaCM_6Li_npa","",200,0,25);
-  VCM_6Li_npa = new TH1I("VCM_6Li_npa","",100,1.5,4.5);
-
-  cos_npa_thetaH = new TH1I("cos_npa_thetaH","",100,-1.1,1.1);
-  Erel_npa_cosThetaH = new TH2I("Erel_npa_cosThetaH","",200,0,3,25,-1,1);
+  Erel_6Li_npa = H1("Erel_6Li_npa");
+  Ex_6Li_npa_trans = H1("Ex_6Li_npa_trans");
+  Ex_6Li_npa_long = H1("Ex_6Li_npa_long");
+  Ex_6Li_npa = H1("Ex_6Li_npa");
+  cos_thetaH_npa = H1("cos_thetaH_npa");
+  ThetaCM_6Li_npa = H1("ThetaCM_6Li_npa");
+  VCM_6Li_npa = H1("VCM_6Li_npa");
+
+  cos_npa_thetaH = H1("cos_npa_thetaH");
+  Erel_npa_cosThetaH = H2("Erel_npa_cosThetaH");
   
-  Erel_6Li_da = new TH1I("Erel_6Li_da","",2000,0,15);
-  Erel_6Li_da_tgate_orA = new TH1I("Erel_6Li_da_tgate_orA","",2000,0,15);
-  Erel_6Li_da_vsDiamond = new TH2I("Erel_6Li_da_vsDiamond","",2000,0,15, 1024,0,4096);
-  Erel_6Li_da_vsDiamond_tgate_orA = new TH2I("Erel_6Li_da_vsDiamond_tgate_orA","",2000,0,15, 1024,0,4096);
-  Ex_6Li_da_trans = new TH1I("Ex_6Li_da_trans","",2000,-5,10);
-  Ex_6Li_da_long = new TH1I("Ex_6Li_da_long","",2000,-5,10);
-  Ex_6Li_da = new TH1I("Ex_6Li_da","",2000,-5,10);
-  cos_thetaH_da = new TH1I("cos_thetaH_da","",100,-1.1,1.1);
-  ThetaCM_6Li_da = new TH1I("ThetaCM_6Li_da","",200,0,25);
-  VCM_6Li_da = new TH1I("VCM_6Li_da","",100,1.5,4.5);
-  VCM_vs_ThetaCM = new TH2I("VCM_vs_ThetaCM","", 200,0,25,100,1.5,4.5);
-
-  cos_da_thetaH = new TH1I("cos_da_thetaH","",100,-1.1,1.1);
-  Erel_da_cosThetaH = new TH2I("Erel_da_cosThetaH","",200,0,3,25,-1,1);
-
-  deutE_gate = new TH1I("deutE_gate","",200,0,35);
-  alphaE_gated = new TH1I("alphaE_gated","",200,0,35);
-  deutE_gate_cosThetaH = new TH2I("deutE_gate_cosThetaH","",200,0,35,100,-1,1);
-  alphaE_gate_cosThetaH = new TH2I("alphaE_gate_cosThetaH","",200,0,35,100,-1,1);
-
-	react_origin_tdiff = new TH1I("react_origin_tdiff","",2000,-100,100);
+  Erel_6Li_da = H1("Erel_6Li_da");
+  Erel_6Li_da_tgate_orA = H1("Erel_6Li_da_tgate_orA");
+  Erel_6Li_da_vsDiamond = H2("Erel_6Li_da_vsDiamond");
+  Erel_6Li_da_vsDiamond_tgate_orA = H2("Erel_6Li_da_vsDiamond_tgate_orA");
+  Ex_6Li_da_trans = H1("Ex_6Li_da_trans");
+  Ex_6Li_da_long = H1("Ex_6Li_da_long");
+  Ex_6Li_da = H1("Ex_6Li_da");
+  cos_thetaH_da = H1("cos_thetaH_da");
+  ThetaCM_6Li_da = H1("ThetaCM_6Li_da");
+  VCM_6Li_da = H1("VCM_6Li_da");
+  VCM_vs_ThetaCM = H2("VCM_vs_ThetaCM");
+
+  cos_da_thetaH = H1("cos_da_thetaH");
+  Erel_da_cosThetaH = H2("Erel_da_cosThetaH");
+
+  deutE_gate = H1("deutE_gate");
+  alphaE_gated = H1("alphaE_gated");
+  deutE_gate_cosThetaH = H2("deutE_gate_cosThetaH");
+  alphaE_gate_cosThetaH = H2("alphaE_gate_cosThetaH");
+
+	react_origin_tdiff = H1("react_origin_tdiff");
 	
-	xyhitmap_6Li_plus = new TH2I("xyhitmap_6Li_plus","",100,-10,10,100,-10,10);
+	xyhitmap_6Li_plus = H2("xyhitmap_6Li_plus");
 	
-	sumDiamond_vs_GobbiEsum_cal_6Li_3plus = new TH2I("sumDiamond_vs_GobbiEsum_cal_6Li_3plus","",200,0,80,100,0,25);	
+	sumDiamond_vs_GobbiEsum_cal_6Li_3plus = H2("sumDiamond_vs_GobbiEsum_cal_6Li_3plus");	
 	
-	sumDiamond_vs_GobbiEsum_cal_6Li_3plus_torA = new TH2I("sumDiamond_vs_GobbiEsum_cal_6Li_3plus_torA","",200,0,80,100,0,25);	
+	sumDiamond_vs_GobbiEsum_cal_6Li_3plus_torA = H2("sumDiamond_vs_GobbiEsum_cal_6Li_3plus_torA");	
 
 	for (int i=0;i<4;i++) {
 		name.str("");
 		name << "Diamond_vs_GobbiEsum_cal_6Li_" << i;
-		Diamond_vs_GobbiEsum_cal_6Li[i] = new TH2I(name.str().c_str(),"",200,0,80,100,0,25);
+		Diamond_vs_GobbiEsum_cal_6Li[i] = H2(name.str().c_str());
 		
 		name.str("");
 		name << "Diamond_vs_GobbiEsum_cal_6Li_torA_" << i;
-		Diamond_vs_GobbiEsum_cal_6Li_torA[i] = new TH2I(name.str().c_str(),"",200,0,80,100,0,25);
+		Diamond_vs_GobbiEsum_cal_6Li_torA[i] = H2(name.str().c_str());
 	}
 
-	Diamond_Ex_6Li = new TH1I("Diamond_Ex_6Li","",200,0,36);
-	Diamond_Ex_6Li_torA = new TH1I("Diamond_Ex_6Li_torA","",200,0,36);
-	Diamond_Ex_6Li_3plus = new TH1I("Diamond_Ex_6Li_3plus","",200,0,36);
-	Diamond_Ex_6Li_3plus_torA = new TH1I("Diamond_Ex_6Li_3plus_torA","",200,0,36);
+	Diamond_Ex_6Li = H1("Diamond_Ex_6Li");
+	Diamond_Ex_6Li_torA = H1("Diamond_Ex_6Li_torA");
+	Diamond_Ex_6Li_3plus = H1("Diamond_Ex_6Li_3plus");
+	Diamond_Ex_6Li_3plus_torA = H1("Diamond_Ex_6Li_3plus_torA");
 
   // Li7
 	// p + 6He
-  dir7Li->cd();
-  Erel_7Li_p6He = new TH1I("Erel_7Li_p6He","",200,0,8);
-  Erel_7Li_p6He_Q = new TH2I("Erel_7Li_p6He_Q","",200,0,8,200,-5,15);
-  Erel_7Li_cosThetaH = new TH2I("Erel_7Li_cosThetaH","",200,0,8,25,-1,1);
-  Erel_7Li_p6He_lowres = new TH1I("Erel_7Li_p6He_lowres","",100,0,8);
-  Ex_7Li_p6He_transverse = new TH1I("Ex_7Li_p6He_transverse","",400,10,18);
-  Ex_7Li_p6He_transverse2 = new TH1I("Ex_7Li_p6He_transverse2","",400,10,18);
-  Erel_7Li_p6He_pFor = new TH1I("Erel_7Li_p6He_pFor","",200,0,17);
-  Ex_7Li_p6He_timegate = new TH1I("Ex_7Li_p6He_timegate","",400,10,18);
-
-  cos_thetaH = new TH1I("cos_thetaH","",100,-1.1,1.1);
-  cos_thetaH_lowErel = new TH1I("cos_thetaH_lowErel","",100,-1.1,1.1);
-  missingmass = new TH1I("missingmass","",500,-150,100);
-  Erel_missingmass = new TH2I("Erel_missingmass","",200,0,8,200,-10,10);
-  Qvalue = new TH1I("Qvalue","",500,-5,15);
-  Qvalue2 = new TH1I("Qvalue2","",500,-5,15);
-  Ex_7Li_p6He_clean = new TH1I("Ex_7Li_p6He_clean","",400,10,18);
-
-  Ex_7Li_p6He = new TH1I("Ex_7Li_p6He","",400,10,18);
-  ThetaCM_7Li_p6He = new TH1I("ThetaCM_7Li_p6He","",200,0,20);
-  VCM_7Li_p6He = new TH1I("VCM_7Li_p6He","",100,1.5,4);
-  VCM_7Li_p6He_lowErel = new TH1I("VCM_7Li_p6He_lowErel","",100,1.5,4);
-  //Vlab_LF_p6He = new TH1I("Vlab_LF_p6He","",100,0,1); //units of v/c
-  //Vlab_HF_p6He = new TH1I("Vlab_HF_p6He","",100,0,1); //units of v/c
-  //cosbeamCMtoHF_Ex_p6He = new TH2I("cosbeamCMtoHF_Ex_p6He","",100,-2,15,100,-1,1); //2d
-
-  dTime_7Li_proton = new TH1I("dTime_7Li_proton","",1500,-4000,2000);
-  dTime_7Li_He6 = new TH1I("dTime_7Li_He6","",1500,-4000,2000);
-
-  Ex_7Li_p6He_ExvsEp = new TH2I("Ex_7Li_p6He_ExvsEp","", 400,10,18, 100,0,16);
+  Erel_7Li_p6He = H1("Erel_7Li_p6He");
+  Erel_7Li_p6He_Q = H2("Erel_7Li_p6He_Q");
+  Erel_7Li_cosThetaH = H2("Erel_7Li_cosThetaH");
+  Erel_7Li_p6He_lowres = H1("Erel_7Li_p6He_lowres");
+  Ex_7Li_p6He_transverse = H1("Ex_7Li_p6He_transverse");
+  Ex_7Li_p6He_transverse2 = H1("Ex_7Li_p6He_transverse2");
+  Erel_7Li_p6He_pFor = H1("Erel_7Li_p6He_pFor");
+  Ex_7Li_p6He_timegate = H1("Ex_7Li_p6He_timegate");
+
+  cos_thetaH = H1("cos_thetaH");
+  cos_thetaH_lowErel = H1("cos_thetaH_lowErel");
+  missingmass = H1("missingmass");
+  Erel_missingmass = H2("Erel_missingmass");
+  Qvalue = H1("Qvalue");
+  Qvalue2 = H1("Qvalue2");
+  Ex_7Li_p6He_clean = H1("Ex_7Li_p6He_clean");
+
+  Ex_7Li_p6He = H1("Ex_7Li_p6He");
+  ThetaCM_7Li_p6He = H1("ThetaCM_7Li_p6He");
+  VCM_7Li_p6He = H1("VCM_7Li_p6He");
+  VCM_7Li_p6He_lowErel = H1("VCM_7Li_p6He_lowErel");
+  //Vlab_LF_p6He = H1("Vlab_LF_p6He"); //units of v/c
+  //Vlab_HF_p6He = H1("Vlab_HF_p6He"); //units of v/c
+  //cosbeamCMtoHF_Ex_p6He = H2("cosbeamCMtoHF_Ex_p6He"); //2d
+
+  dTime_7Li_proton = H1("dTime_7Li_proton");
+  dTime_7Li_He6 = H1("dTime_7Li_He6");
+
+  Ex_7Li_p6He_ExvsEp = H2("Ex_7Li_p6He_ExvsEp");
 
 	// t + alpha
-  Erel_7Li_ta = new TH1I("Erel_7Li_ta","",400,0,8);
-  Ex_7Li_ta = new TH1I("Ex_7Li_ta","",400,2,10);
-  Ex_7Li_ta_trans = new TH1I("Ex_7Li_ta_trans","",400,2,10);
-  Ex_7Li_ta_long = new TH1I("Ex_7Li_ta_long","",400,2,10);
-  Ex_7Li_ta_bad = new TH1I("Ex_7Li_ta_bad","",400,2,10);
-  ThetaCM_7Li_ta = new TH1I("ThetaCM_7Li_ta","",200,0,25);
-  VCM_7Li_ta = new TH1I("VCM_7Li_ta","",100,1.5,4.5);
-  cos_ta_thetaH = new TH1I("cos_ta_thetaH","",100,-1.1,1.1);
-  Erel_ta_cosThetaH = new TH2I("Erel_ta_cosThetaH","",200,0,8,25,-1,1);
-  Ex_tar = new TH1I("Ex_tar","",400,-20,20);
-  Erel_vs_Extar = new TH2I("Erel_vs_Extar","",100,0,8,100,-20,20);
-
-  Ex_7Li_ta_timegate = new TH1I("Ex_7Li_ta_timegate","",400,2,10);
-  hitmapcheck1 = new TH2I("hitmapcheck1","", 100,-10,10,100,-10,10);
-  hitmapcheck2 = new TH2I("hitmapcheck2","", 100,-10,10,100,-10,10);
-  dTime_7Li_triton = new TH1I("dTime_7Li_triton","",1500,-4000,2000);
-  dTime_7Li_alpha = new TH1I("dTime_7Li_alpha","",1500,-4000,2000);
-
-  seperate_quad_Ex_7Li_ta = new TH1I("seperate_quad_Ex_7Li_ta","",400,2,10);
-
-  DEE_shoulderevents = new TH2I("DEE_shoulderevents","",500,0,80,800,0,22);
+  Erel_7Li_ta = H1("Erel_7Li_ta");
+  Ex_7Li_ta = H1("Ex_7Li_ta");
+  Ex_7Li_ta_trans = H1("Ex_7Li_ta_trans");
+  Ex_7Li_ta_long = H1("Ex_7Li_ta_long");
+  Ex_7Li_ta_bad = H1("Ex_7Li_ta_bad");
+  ThetaCM_7Li_ta = H1("ThetaCM_7Li_ta");
+  VCM_7Li_ta = H1("VCM_7Li_ta");
+  cos_ta_thetaH = H1("cos_ta_thetaH");
+  Erel_ta_cosThetaH = H2("Erel_ta_cosThetaH");
+  Ex_tar = H1("Ex_tar");
+  Erel_vs_Extar = H2("Erel_vs_Extar");
+
+  Ex_7Li_ta_timegate = H1("Ex_7Li_ta_timegate");
+  hitmapcheck1 = H2("hitmapcheck1");
+  hitmapcheck2 = H2("hitmapcheck2");
+  dTime_7Li_triton = H1("dTime_7Li_triton");
+  dTime_7Li_alpha = H1("dTime_7Li_alpha");
+
+  seperate_quad_Ex_7Li_ta = H1("seperate_quad_Ex_7Li_ta");
+
+  DEE_shoulderevents = H2("DEE_shoulderevents");
 
   // Be6
-  dir6Be->cd();
-  Erel_6Be_2pa = new TH1I("Erel_6Be_2pa","",800,0,30);
-  ThetaCM_6Be_2pa = new TH1I("ThetaCM_6Be_2pa","",200,0,10);
-  VCM_6Be_2pa = new TH1I("VCM_6Be_2pa","",100,0,14);
+  Erel_6Be_2pa = H1("Erel_6Be_2pa");
+  ThetaCM_6Be_2pa = H1("ThetaCM_6Be_2pa");
+  VCM_6Be_2pa = H1("VCM_6Be_2pa");
 
   // Be7
-  dir7Be->cd();
-  Erel_7Be_a3He = new TH1I("Erel_7Be_a3He","",800,0,30);
-  Ex_7Be_a3He = new TH1I("Ex_7Be_a3He","",800,-5,30);
-  ThetaCM_7Be_a3He = new TH1I("ThetaCM_7Be_a3He","",200,0,10);
-  VCM_7Be_a3He = new TH1I("VCM_7Be_a3He","",100,0,14);
+  Erel_7Be_a3He = H1("Erel_7Be_a3He");
+  Ex_7Be_a3He = H1("Ex_7Be_a3He");
+  ThetaCM_7Be_a3He = H1("ThetaCM_7Be_a3He");
+  VCM_7Be_a3He = H1("VCM_7Be_a3He");
 
-  Erel_7Be_p6Li = new TH1I("Erel_7Be_p6Li","",800,0,30);
-  Ex_7Be_p6Li = new TH1I("Ex_7Be_p6Li","",800,-5,30);
-  ThetaCM_7Be_p6Li = new TH1I("ThetaCM_7Be_p6Li","",200,0,10);
-  VCM_7Be_p6Li = new TH1I("VCM_7Be_p6Li","",100,0,14);
+  Erel_7Be_p6Li = H1("Erel_7Be_p6Li");
+  Ex_7Be_p6Li = H1("Ex_7Be_p6Li");
+  ThetaCM_7Be_p6Li = H1("ThetaCM_7Be_p6Li");
+  VCM_7Be_p6Li = H1("VCM_7Be_p6Li");
 
   // Be8
-  dir8Be->cd();
-  Erel_8Be_aa = new TH1I("Erel_8Be_aa","",800,0,17);
-  Ex_8Be_aa = new TH1I("Ex_8Be_aa","",1600,-1,7);
-  ThetaCM_8Be_aa = new TH1I("ThetaCM_8Be_aa","",200,0,25);
-  VCM_8Be_aa = new TH1I("VCM_8Be_aa","",100,0,14);
-  Erel_aa_cosThetaH = new TH2I("Erel_aa_cosThetaH","",100,0,8,25,-1,1);
-
-  Erel_8Be_p7Li = new TH1I("Erel_8Be_p7Li","",800,0,17);
-  Ex_8Be_p7Li = new TH1I("Ex_8Be_p7Li","",400,17,25);
-  Ex_8Be_p7Li_trans = new TH1I("Ex_8Be_p7Li_trans","",400,17,25);
-  ThetaCM_8Be_p7Li = new TH1I("ThetaCM_8Be_p7Li","",100,0,15);
-  VCM_8Be_p7Li = new TH1I("VCM_8Be_p7Li","",50,2,4);
-  cos_p7Li_thetaH = new TH1I("cos_p7Li_thetaH","",100,-1.1,1.1);
-  Erel_p7Li_cosThetaH = new TH2I("Erel_p7Li_cosThetaH","",200,0,8,25,-1,1);
-
-  ProtonEnergies_p7Li = new TH1I("ProtonEnergies_p7Li","",200,0,40);
-  LithiumEnergies_p7Li = new TH1I("LithiumEnergies_p7Li","",200,0,40);
-
-  dTime_8Be_proton = new TH1I("dTime_8Be_proton","",1500,-4000,2000);
-  dTime_8Be_Li7 = new TH1I("dTime_8Be_Li7","",1500,-4000,2000);
-
-  Ex_8Be_p7Li_timegate = new TH1I("Ex_8Be_p7Li_timegate","",400,17,25);
-
-  Erel_8Be_pta = new TH1I("Erel_8Be_pta","",800,0,30);
-  Ex_8Be_pta = new TH1I("Ex_8Be_pta","",250,20,25);
-  Ex_8Be_pta_trans = new TH1I("Ex_8Be_pta_trans","",250,20,25);
-  ThetaCM_8Be_pta = new TH1I("ThetaCM_8Be_pta","",200,0,10);
-  VCM_8Be_pta = new TH1I("VCM_8Be_pta","",100,0,14);
-  cos_pta_thetaH = new TH1I("cos_pta_thetaH","",100,-1.1,1.1);
-  Erel_pta_cosThetaH = new TH2I("Erel_pta_cosThetaH","",200,0,8,25,-1,1);
-
-  Erel_7Li_ta_fake = new TH1I("Erel_7Li_ta_fake","",400,0,8);
-  Ex_7Li_ta_fake = new TH1I("Ex_7Li_ta_fake","",400,2,10);
-
-  Ex_8Be_7LiGate = new TH1I("Ex_8Be_pta_7LiGate","",250,20,25);
+  Erel_8Be_aa = H1("Erel_8Be_aa");
+  Ex_8Be_aa = H1("Ex_8Be_aa");
+  ThetaCM_8Be_aa = H1("ThetaCM_8Be_aa");
+  VCM_8Be_aa = H1("VCM_8Be_aa");
+  Erel_aa_cosThetaH = H2("Erel_aa_cosThetaH");
+
+  Erel_8Be_p7Li = H1("Erel_8Be_p7Li");
+  Ex_8Be_p7Li = H1("Ex_8Be_p7Li");
+  Ex_8Be_p7Li_trans = H1("Ex_8Be_p7Li_trans");
+  ThetaCM_8Be_p7Li = H1("ThetaCM_8Be_p7Li");
+  VCM_8Be_p7Li = H1("VCM_8Be_p7Li");
+  cos_p7Li_thetaH = H1("cos_p7Li_thetaH");
+  Erel_p7Li_cosThetaH = H2("Erel_p7Li_cosThetaH");
+
+  ProtonEnergies_p7Li = H1("ProtonEnergies_p7Li");
+  LithiumEnergies_p7Li = H1("LithiumEnergies_p7Li");
+
+  dTime_8Be_proton = H1("dTime_8Be_proton");
+  dTime_8Be_Li7 = H1("dTime_8Be_Li7");
+
+  Ex_8Be_p7Li_timegate = H1("Ex_8Be_p7Li_timegate");
+
+  Erel_8Be_pta = H1("Erel_8Be_pta");
+  Ex_8Be_pta = H1("Ex_8Be_pta");
+  Ex_8Be_pta_trans = H1("Ex_8Be_pta_trans");
+  ThetaCM_8Be_pta = H1("ThetaCM_8Be_pta");
+  VCM_8Be_pta = H1("VCM_8Be_pta");
+  cos_pta_thetaH = H1("cos_pta_thetaH");
+  Erel_pta_cosThetaH = H2("Erel_pta_cosThetaH");
+
+  Erel_7Li_ta_fake = H1("Erel_7Li_ta_fake");
+  Ex_7Li_ta_fake = H1("Ex_7Li_ta_fake");
+
+  Ex_8Be_7LiGate = H1("Ex_8Be_pta_7LiGate");
 
   // B9
-  dir9B->cd();
-  Erel_9B_paa = new TH1I("Erel_9B_paa","",800,0,17);
-  Ex_9B_paa = new TH1I("Ex_9B_paa","",800,-2,15);
-  Ex_9B_p8Be = new TH1I("Ex_9B_p8Be","",800,-2,15);
-  Ex_9B_aa = new TH1I("Ex_8Be_in_9B_aa","",800,-2,15);
-  ThetaCM_9B_paa = new TH1I("ThetaCM_9B_paa","",200,0,10);
-  VCM_9B_paa = new TH1I("VCM_9B_paa","",100,0,14);
+  Erel_9B_paa = H1("Erel_9B_paa");
+  Ex_9B_paa = H1("Ex_9B_paa");
+  Ex_9B_p8Be = H1("Ex_9B_p8Be");
+  Ex_9B_aa = H1("Ex_8Be_in_9B_aa");
+  ThetaCM_9B_paa = H1("ThetaCM_9B_paa");
+  VCM_9B_paa = H1("VCM_9B_paa");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 histo::~histo() {
-  file_read->Write();
+  file_read->Write(); // only tpar, the spectra are written by HistStore::Write
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void histo::Fill() {
 
-	// Transfer TexNeut values to output class
+	// Transfer TexNeut values to output class. TNLIB only has per-hit getters
+	// keyed by strings ("top"/"bot", "pre"/...), about 22 calls per hit. A
+	// zero-copy export needs enum-indexed or bulk accessors in lib/TNLIB first
 	texneutout.clear();
 	texneutmult = texneut.get_coupledhits();
 	for (size_t i = 0; i < texneutmult; i++) {
@@ -11,6 +11,7 @@
 #include <TTree.h>
 
 #include <cmath>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -20,6 +21,7 @@
 
 #include <eventclass.hpp>
 
+#include "HistStore.h"
 #include "OutStructs.h"
 
 class histo {
@@ -34,6 +36,13 @@ private:
 	size_t texneutmult{0};              // number of successful pairs of hits per event in TexNeut, a.k.a. "bars"
 	std::vector<OutStructs::TexNeutHit> texneutout; // hit list from TexNeut data containing bar-wise information, should be "texneutmult" in length
 
+	// Spectrum handles of this task, looked up by name in HistStore. The bin
+	// contents belong to the thread, these only point at them.
+	std::deque<FlatH1> hists1d;
+	std::deque<FlatH2> hists2d;
+	FlatH1* H1(const std::string& name) { return &hists1d.emplace_back(HistStore::Find(name, 1)); }
+	FlatH2* H2(const std::string& name) { return &hists2d.emplace_back(HistStore::Find(name, 2)); }
+
 public:
 
 	histo(std::shared_ptr<ROOT::TBufferMergerFile>, event& texneutevent);
@@ -46,11 +55,9 @@ public:
 	
 	/******** TEXNEUT STUFF ********/
 	
-	TDirectoryFile* dirTexNeut;
-	
-	TH2I* topDownMap;
-	TH2I* barZeroFingers;
-	TH1I* neutron_mult;
+	FlatH2* topDownMap;
+	FlatH2* barZeroFingers;
+	FlatH1* neutron_mult;
 	
 	/*******************************/
 
@@ -60,341 +67,307 @@ public:
 	static const int boardnum = 12;   // total number of boards (not used; was 16, should be 12)
 	static const int channum = 32;    // number of channels on each board
 
-	TDirectoryFile* dirSummary;
-
-	TDirectory* dir1dFrontE_R;
-	TDirectory* dir1dBackE_R;
-	TDirectory* dir1dDeltaE_R;
-	TDirectory* dir1dFrontlowE_R;
-	TDirectory* dir1dBacklowE_R;
-	TDirectory* dir1dDeltalowE_R;
-	TDirectory* dir1dFrontE_cal;
-	TDirectory* dir1dBackE_cal;
-	TDirectory* dir1dDeltaE_cal;
-	TDirectory* dirAngleCorrFrontE;
-	TDirectory* dirAngleCorrDeltaE;
-	TDirectory* dir1dFrontTime_R;
-	TDirectory* dir1dBackTime_R;
-	TDirectory* dir1dDeltaTime_R;
-	
-	TDirectoryFile* dirDiamond;
-	
-	TDirectoryFile* dirTDC;
-
-	TDirectoryFile* dirDEEplots; // directory for deltaE-E plots used in particle identificaiton
-	TDirectoryFile* dirhitmaps;  // directory for all particle type hitmaps
-
-	TDirectoryFile* dirInvMass;  // directory for all correlations and inv-mass
-	TDirectory* dir4He;
-	TDirectory* dir5He;
-	TDirectory* dir6He;
-	TDirectory* dir5Li;
-	TDirectory* dir6Li;
-	TDirectory* dir7Li;
-	TDirectory* dir6Be;
-	TDirectory* dir7Be;
-	TDirectory* dir8Be;
-	TDirectory* dir9B;
-
 	// Summary plots
-	TH2I* sumFrontE_R;
-	TH2I* sumBackE_R;
-	TH2I* sumDeltaE_R;
-	TH2I* sumFrontE_cal;
-	TH2I* sumFrontE_addback;
-	TH2I* sumBackE_cal;
-	TH2I* sumBackE_addback;
-	TH2I* sumDeltaE_cal;
-	TH2I* sumDeltaE_addback;
-	TH2I* sumEtot_cal;
-	TH2I* AngleCorrSum_cal;
-	TH2I* AngleCorrFrontE_cal;
-	TH2I* AngleCorrDeltaE_cal;
-	TH2I* sumFrontTime_R;
-	TH2I* sumFrontTime_cal;
-	TH2I* sumBackTime_R;
-	TH2I* sumBackTime_cal;
-	TH2I* sumDeltaTime_R;
-	TH2I* sumDeltaTime_cal;
-	//TH2I* FrontvsBack;
-	TH2I* FrontvsBack[4];
-
-	TH2I* sumFrontTimeMult1_cal;
+	FlatH2* sumFrontE_R;
+	FlatH2* sumBackE_R;
+	FlatH2* sumDeltaE_R;
+	FlatH2* sumFrontE_cal;
+	FlatH2* sumFrontE_addback;
+	FlatH2* sumBackE_cal;
+	FlatH2* sumBackE_addback;
+	FlatH2* sumDeltaE_cal;
+	FlatH2* sumDeltaE_addback;
+	FlatH2* sumEtot_cal;
+	FlatH2* AngleCorrSum_cal;
+	FlatH2* AngleCorrFrontE_cal;
+	FlatH2* AngleCorrDeltaE_cal;
+	FlatH2* sumFrontTime_R;
+	FlatH2* sumFrontTime_cal;
+	FlatH2* sumBackTime_R;
+	FlatH2* sumBackTime_cal;
+	FlatH2* sumDeltaTime_R;
+	FlatH2* sumDeltaTime_cal;
+	//FlatH2* FrontvsBack;
+	FlatH2* FrontvsBack[4];
+
+	FlatH2* sumFrontTimeMult1_cal;
 
 	// E silicon plots
-	TH1I* FrontE_R[4][channum];
-	TH1I* FrontElow_R[4][channum];
-	TH1I* FrontTime_R[4][channum];
-	TH1I* FrontE_cal[4][channum];
-	TH1I* BackE_R[4][channum];
-	TH1I* BackElow_R[4][channum];
-	TH1I* BackTime_R[4][channum];
-	TH1I* BackE_cal[4][channum];
-
-	TH1I* AngleCorrE[4][channum];
-	TH1I* AngleCorr_noCorr[4][channum];
-	TH1I* AngleCorrE_R[4][channum];
+	FlatH1* FrontE_R[4][channum];
+	FlatH1* FrontElow_R[4][channum];
+	FlatH1* FrontTime_R[4][channum];
+	FlatH1* FrontE_cal[4][channum];
+	FlatH1* BackE_R[4][channum];
+	FlatH1* BackElow_R[4][channum];
+	FlatH1* BackTime_R[4][channum];
+	FlatH1* BackE_cal[4][channum];
+
+	FlatH1* AngleCorrE[4][channum];
+	FlatH1* AngleCorr_noCorr[4][channum];
+	FlatH1* AngleCorrE_R[4][channum];
 
 	//Diamond detector plots
-	TH1I* DiamondQDC0;
-	TH1I* DiamondQDC0_cal;
-	TH1I* DiamondQDC1;
-	TH1I* DiamondQDC1_cal;
+	FlatH1* DiamondQDC0;
+	FlatH1* DiamondQDC0_cal;
+	FlatH1* DiamondQDC1;
+	FlatH1* DiamondQDC1_cal;
 	
-	TH1I* DiamondQDC0_tgate_orA;
-	TH1I* DiamondQDC0_tgate_orA_cal;
-	TH2I* DiamondQDC0_vs_torA;
-	TH2I* DiamondQDC0_vs_torA_cal;
+	FlatH1* DiamondQDC0_tgate_orA;
+	FlatH1* DiamondQDC0_tgate_orA_cal;
+	FlatH2* DiamondQDC0_vs_torA;
+	FlatH2* DiamondQDC0_vs_torA_cal;
 	
-	TH2I* Diamond_vs_GobbiEsum[4];
-	TH2I* Diamond_vs_GobbiEsum_cal[4];
-	TH2I* Diamond_vs_GobbiEsum_torA[4];
-	TH2I* Diamond_vs_GobbiEsum_torA_cal[4];
+	FlatH2* Diamond_vs_GobbiEsum[4];
+	FlatH2* Diamond_vs_GobbiEsum_cal[4];
+	FlatH2* Diamond_vs_GobbiEsum_torA[4];
+	FlatH2* Diamond_vs_GobbiEsum_torA_cal[4];
 	
 	//TDC plots
-	TH1I * TDC_Plot[16];
-	TH2I * TDC_sum;
-	TH2I * TDC_sum_TN;
-	TH2I * TDC_sum_TN_shift; //Shifted gamma peak relative to the 1st board
-	TH1I * TDC_Plot_TN_shift[12];
+	FlatH1 * TDC_Plot[16];
+	FlatH2 * TDC_sum;
+	FlatH2 * TDC_sum_TN;
+	FlatH2 * TDC_sum_TN_shift; //Shifted gamma peak relative to the 1st board
+	FlatH1 * TDC_Plot_TN_shift[12];
 
 	// Delta E silicon plots
-	TH1I* DeltaE_R[4][channum];
-	TH1I* DeltaElow_R[4][channum];
-	TH1I* DeltaTime_R[4][channum];
-	TH1I* DeltaE_cal[4][channum];
+	FlatH1* DeltaE_R[4][channum];
+	FlatH1* DeltaElow_R[4][channum];
+	FlatH1* DeltaTime_R[4][channum];
+	FlatH1* DeltaE_cal[4][channum];
 
-	TH1I* AngleCorrDeltaE[4][channum];
-	TH1I* AngleCorrDeltaE_noCorr[4][channum];
-	TH1I* AngleCorrDeltaE_R[4][channum];
+	FlatH1* AngleCorrDeltaE[4][channum];
+	FlatH1* AngleCorrDeltaE_noCorr[4][channum];
+	FlatH1* AngleCorrDeltaE_R[4][channum];
 
 	// DeltaE-E plots
-	TH2I* DEE_simple[4];
-	TH2I* frontdeltastripnum[4];
-	TH2I* DEE[4];
-	TH1I* timediff[4];
-
-	TH2I* xyhitmap_allE;
-	TH2I* xyhitmap;
-	TH2I* xyhitmap_EdEgate_1stEL;
-	TH2I* xyhitmap_EdEgate_2ndEL;
-	TH2I* xyhitmap_tgate_orA;
-	TH2I* protonhitmap;
-	TH2I* deuteronhitmap;
-	TH2I* tritonhitmap;
-	TH2I* alphahitmap;
-	TH2I* He6hitmap;
-	TH2I* Lihitmap;
-	TH2I* LiVETOhitmap;
-	TH2I* hitmapof_p;
-	TH2I* hitmapof_6He;
+	FlatH2* DEE_simple[4];
+	FlatH2* frontdeltastripnum[4];
+	FlatH2* DEE[4];
+	FlatH1* timediff[4];
+	FlatH1* PIDlin[4];
+	FlatH2* PIDlin_E[4];
+
+	FlatH2* xyhitmap_allE;
+	FlatH2* xyhitmap;
+	FlatH2* xyhitmap_EdEgate_1stEL;
+	FlatH2* xyhitmap_EdEgate_2ndEL;
+	FlatH2* xyhitmap_tgate_orA;
+	FlatH2* protonhitmap;
+	FlatH2* deuteronhitmap;
+	FlatH2* tritonhitmap;
+	FlatH2* alphahitmap;
+	FlatH2* He6hitmap;
+	FlatH2* Lihitmap;
+	FlatH2* LiVETOhitmap;
+	FlatH2* hitmapof_p;
+	FlatH2* hitmapof_6He;
 	
-	TH2I* xyhitmap_DiamondELlow;
-	TH2I* xyhitmap_DiamondELpeak;
-	TH2I* xyhitmap_DiamondELhigh;
+	FlatH2* xyhitmap_DiamondELlow;
+	FlatH2* xyhitmap_DiamondELpeak;
+	FlatH2* xyhitmap_DiamondELhigh;
 
-	TH2I* Evstheta[4];
-	TH2I* Evstheta_all;
-	TH1I* Theta;
+	FlatH2* Evstheta[4];
+	FlatH2* Evstheta_all;
+	FlatH1* Theta;
 
-	TH2I* ProtonEnergy;
+	FlatH2* ProtonEnergy;
 
-	TH1I* dTime_proton;
-	TH1I* dTime_deuteron;
-	TH1I* dTime_triton;
-	TH1I* dTime_alpha;
-	TH1I* dTime_He6;
-	TH1I* dTime_Li;
-	TH2I* CorrelationTable;
+	FlatH1* dTime_proton;
+	FlatH1* dTime_deuteron;
+	FlatH1* dTime_triton;
+	FlatH1* dTime_alpha;
+	FlatH1* dTime_He6;
+	FlatH1* dTime_Li;
+	FlatH2* CorrelationTable;
 
 	/******** CORRELATIONS AND INVARIANT MASS PLOTS ********/
 
 	// He4
-	TH1I* Erel_4He_pt;
-	TH1I* Ex_4He_pt;
-	TH1I* ThetaCM_4He_pt;
-	TH1I* VCM_4He_pt;
-	TH2I* He4_p_hitmap;
-	TH2I* He4_t_hitmap;
-	TH2I* DEE_He4[4];
-	TH2I* Erel_pt_costhetaH;
-
-	TH1I* Erel_4He_dd;
-	TH1I* Ex_4He_dd;
-	TH1I* ThetaCM_4He_dd;
-	TH1I* VCM_4He_dd;
-	TH2I* Erel_dd_costhetaH;
+	FlatH1* Erel_4He_pt;
+	FlatH1* Ex_4He_pt;
+	FlatH1* ThetaCM_4He_pt;
+	FlatH1* VCM_4He_pt;
+	FlatH2* He4_p_hitmap;
+	FlatH2* He4_t_hitmap;
+	FlatH2* DEE_He4[4];
+	FlatH2* Erel_pt_costhetaH;
+
+	FlatH1* Erel_4He_dd;
+	FlatH1* Ex_4He_dd;
+	FlatH1* ThetaCM_4He_dd;
+	FlatH1* VCM_4He_dd;
+	FlatH2* Erel_dd_costhetaH;
 
 	// He5
-	TH1I* Erel_5He_dt;
-	TH1I* Ex_5He_dt;
-	TH1I* ThetaCM_5He_dt;
-	TH1I* VCM_5He_dt;
+	FlatH1* Erel_5He_dt;
+	FlatH1* Ex_5He_dt;
+	FlatH1* ThetaCM_5He_dt;
+	FlatH1* VCM_5He_dt;
 
 	// He6
-	TH1I* Erel_6He_tt;
-	TH1I* Ex_6He_tt;
-	TH1I* ThetaCM_6He_tt;
-	TH1I* VCM_6He_tt;
+	FlatH1* Erel_6He_tt;
+	FlatH1* Ex_6He_tt;
+	FlatH1* ThetaCM_6He_tt;
+	FlatH1* VCM_6He_tt;
 
 	// Li5
-	TH1I* Erel_5Li_pa;
-	TH1I* Ex_5Li_pa;
-	TH1I* ThetaCM_5Li_pa;
-	TH1I* VCM_5Li_pa;
+	FlatH1* Erel_5Li_pa;
+	FlatH1* Ex_5Li_pa;
+	FlatH1* ThetaCM_5Li_pa;
+	FlatH1* VCM_5Li_pa;
 
-	TH1I* Erel_5Li_d3He;
-	TH1I* Ex_5Li_d3He;
-	TH1I* ThetaCM_5Li_d3He;
-	TH1I* VCM_5Li_d3He;
+	FlatH1* Erel_5Li_d3He;
+	FlatH1* Ex_5Li_d3He;
+	FlatH1* ThetaCM_5Li_d3He;
+	FlatH1* VCM_5Li_d3He;
 
 	// Li6
 	// -> p + n + alpa
-	TH1I* Erel_6Li_npa;
-	TH1I* Ex_6Li_npa_trans;
-	TH1I* Ex_6Li_npa_long;
-	TH1I* Ex_6Li_npa;
-	TH1I* cos_thetaH_npa;
-	TH1I* ThetaCM_6Li_npa;
-	TH1I* VCM_6Li_npa;
-	TH1I* cos_npa_thetaH;
-	TH2I* Erel_npa_cosThetaH;
+	FlatH1* Erel_6Li_npa;
+	FlatH1* Ex_6Li_npa_trans;
+	FlatH1* Ex_6Li_npa_long;
+	FlatH1* Ex_6Li_npa;
+	FlatH1* cos_thetaH_npa;
+	FlatH1* ThetaCM_6Li_npa;
+	FlatH1* VCM_6Li_npa;
+	FlatH1* cos_npa_thetaH;
+	FlatH2* Erel_npa_cosThetaH;
 	
-	TH1I* Erel_6Li_da;
-	TH1I* Erel_6Li_da_tgate_orA;
-	TH2I* Erel_6Li_da_vsDiamond;
-	TH2I* Erel_6Li_da_vsDiamond_tgate_orA;
-	TH1I* Ex_6Li_da_trans;
-	TH1I* Ex_6Li_da_long;
-	TH1I* Ex_6Li_da;
-	TH1I* cos_thetaH_da;
-	TH1I* ThetaCM_6Li_da;
-	TH1I* VCM_6Li_da;
-	TH2I* VCM_vs_ThetaCM;
-	TH1I* cos_da_thetaH;
-	TH2I* Erel_da_cosThetaH;
-	TH1I* deutE_gate;
-	TH1I* alphaE_gated;
-	TH2I* deutE_gate_cosThetaH;
-	TH2I* alphaE_gate_cosThetaH;
-	TH1I* react_origin_tdiff;
+	FlatH1* Erel_6Li_da;
+	FlatH1* Erel_6Li_da_tgate_orA;
+	FlatH2* Erel_6Li_da_vsDiamond;
+	FlatH2* Erel_6Li_da_vsDiamond_tgate_orA;
+	FlatH1* Ex_6Li_da_trans;
+	FlatH1* Ex_6Li_da_long;
+	FlatH1* Ex_6Li_da;
+	FlatH1* cos_thetaH_da;
+	FlatH1* ThetaCM_6Li_da;
+	FlatH1* VCM_6Li_da;
+	FlatH2* VCM_vs_ThetaCM;
+	FlatH1* cos_da_thetaH;
+	FlatH2* Erel_da_cosThetaH;
+	FlatH1* deutE_gate;
+	FlatH1* alphaE_gated;
+	FlatH2* deutE_gate_cosThetaH;
+	FlatH2* alphaE_gate_cosThetaH;
+	FlatH1* react_origin_tdiff;
 	
-	TH2I* xyhitmap_6Li_plus;
+	FlatH2* xyhitmap_6Li_plus;
 	
-	TH2I* sumDiamond_vs_GobbiEsum_cal_6Li_3plus;
+	FlatH2* sumDiamond_vs_GobbiEsum_cal_6Li_3plus;
 	
-	TH2I* sumDiamond_vs_GobbiEsum_cal_6Li_3plus_torA;
+	FlatH2* sumDiamond_vs_GobbiEsum_cal_6Li_3plus_torA;
 	
-	TH2I* Diamond_vs_GobbiEsum_cal_6Li[4];
-	TH2I* Diamond_vs_GobbiEsum_cal_6Li_torA[4];
+	FlatH2* Diamond_vs_GobbiEsum_cal_6Li[4];
+	FlatH2* Diamond_vs_GobbiEsum_cal_6Li_torA[4];
 
-	TH1I* Diamond_Ex_6Li;
-	TH1I* Diamond_Ex_6Li_torA;
-	TH1I* Diamond_Ex_6Li_3plus;
-	TH1I* Diamond_Ex_6Li_3plus_torA;
+	FlatH1* Diamond_Ex_6Li;
+	FlatH1* Diamond_Ex_6Li_torA;
+	FlatH1* Diamond_Ex_6Li_3plus;
+	FlatH1* Diamond_Ex_6Li_3plus_torA;
 
 	// Li7
-	TH1I* Erel_7Li_p6He;
-	TH2I* Erel_7Li_p6He_Q;
-	TH2I* Erel_7Li_cosThetaH;
-	TH1I* Erel_7Li_p6He_lowres;
-	TH1I* Ex_7Li_p6He_transverse;
-	TH1I* Ex_7Li_p6He_transverse2;
-	TH1I* Erel_7Li_p6He_pFor;
-	TH1I* Ex_7Li_p6He_timegate;
-	TH1I* cos_thetaH;
-	TH1I* cos_thetaH_lowErel;
-	TH1I* missingmass;
-	TH2I* Erel_missingmass;
-	TH1I* Qvalue;
-	TH1I* Qvalue2;
-	TH1I* Ex_7Li_p6He_clean;
-	TH1I* Ex_7Li_p6He;
-	TH1I* ThetaCM_7Li_p6He;
-	TH1I* VCM_7Li_p6He;
-	TH1I* VCM_7Li_p6He_lowErel;
-	TH1I* dTime_7Li_proton;
-	TH1I* dTime_7Li_He6;
-	TH2I* Ex_7Li_p6He_ExvsEp;
-
-	TH1I* Erel_7Li_ta;
-	TH1I* Ex_7Li_ta;
-	TH1I* Ex_7Li_ta_trans;
-	TH1I* Ex_7Li_ta_long;
-	TH1I* Ex_7Li_ta_bad;
-	TH1I* ThetaCM_7Li_ta;
-	TH1I* VCM_7Li_ta;
-	TH1I* cos_ta_thetaH;
-	TH2I* Erel_ta_cosThetaH;
-	TH1I* Ex_tar;
-	TH2I* Erel_vs_Extar;
-	TH1I* Ex_7Li_ta_timegate;
-	TH2I* hitmapcheck1;
-	TH2I* hitmapcheck2;
-	TH1I* dTime_7Li_triton;
-	TH1I* dTime_7Li_alpha;
-	TH1I* seperate_quad_Ex_7Li_ta;
-	TH2I* DEE_shoulderevents;
+	FlatH1* Erel_7Li_p6He;
+	FlatH2* Erel_7Li_p6He_Q;
+	FlatH2* Erel_7Li_cosThetaH;
+	FlatH1* Erel_7Li_p6He_lowres;
+	FlatH1* Ex_7Li_p6He_transverse;
+	FlatH1* Ex_7Li_p6He_transverse2;
+	FlatH1* Erel_7Li_p6He_pFor;
+	FlatH1* Ex_7Li_p6He_timegate;
+	FlatH1* cos_thetaH;
+	FlatH1* cos_thetaH_lowErel;
+	FlatH1* missingmass;
+	FlatH2* Erel_missingmass;
+	FlatH1* Qvalue;
+	FlatH1* Qvalue2;
+	FlatH1* Ex_7Li_p6He_clean;
+	FlatH1* Ex_7Li_p6He;
+	FlatH1* ThetaCM_7Li_p6He;
+	FlatH1* VCM_7Li_p6He;
+	FlatH1* VCM_7Li_p6He_lowErel;
+	FlatH1* dTime_7Li_proton;
+	FlatH1* dTime_7Li_He6;
+	FlatH2* Ex_7Li_p6He_ExvsEp;
+
+	FlatH1* Erel_7Li_ta;
+	FlatH1* Ex_7Li_ta;
+	FlatH1* Ex_7Li_ta_trans;
+	FlatH1* Ex_7Li_ta_long;
+	FlatH1* Ex_7Li_ta_bad;
+	FlatH1* ThetaCM_7Li_ta;
+	FlatH1* VCM_7Li_ta;
+	FlatH1* cos_ta_thetaH;
+	FlatH2* Erel_ta_cosThetaH;
+	FlatH1* Ex_tar;
+	FlatH2* Erel_vs_Extar;
+	FlatH1* Ex_7Li_ta_timegate;
+	FlatH2* hitmapcheck1;
+	FlatH2* hitmapcheck2;
+	FlatH1* dTime_7Li_triton;
+	FlatH1* dTime_7Li_alpha;
+	FlatH1* seperate_quad_Ex_7Li_ta;
+	FlatH2* DEE_shoulderevents;
 
 	// Be6
-	TH1I* Erel_6Be_2pa;
-	TH1I* ThetaCM_6Be_2pa;
-	TH1I* VCM_6Be_2pa;
+	FlatH1* Erel_6Be_2pa;
+	FlatH1* ThetaCM_6Be_2pa;
+	FlatH1* VCM_6Be_2pa;
 
 	// Be7
-	TH1I* Erel_7Be_a3He;
-	TH1I* Ex_7Be_a3He;
-	TH1I* ThetaCM_7Be_a3He;
-	TH1I* VCM_7Be_a3He;
+	FlatH1* Erel_7Be_a3He;
+	FlatH1* Ex_7Be_a3He;
+	FlatH1* ThetaCM_7Be_a3He;
+	FlatH1* VCM_7Be_a3He;
 
-	TH1I* Erel_7Be_p6Li;
-	TH1I* Ex_7Be_p6Li;
-	TH1I* ThetaCM_7Be_p6Li;
-	TH1I* VCM_7Be_p6Li;
+	FlatH1* Erel_7Be_p6Li;
+	FlatH1* Ex_7Be_p6Li;
+	FlatH1* ThetaCM_7Be_p6Li;
+	FlatH1* VCM_7Be_p6Li;
 
 	// Be8
-	TH1I* Erel_8Be_aa;
-	TH1I* Ex_8Be_aa;
-	TH1I* ThetaCM_8Be_aa;
-	TH1I* VCM_8Be_aa;
-	TH2I* Erel_aa_cosThetaH;
+	FlatH1* Erel_8Be_aa;
+	FlatH1* Ex_8Be_aa;
+	FlatH1* ThetaCM_8Be_aa;
+	FlatH1* VCM_8Be_aa;
+	FlatH2* Erel_aa_cosThetaH;
 
-	TH1I* Erel_8Be_p7Li;
-	TH1I* Ex_8Be_p7Li;
-	TH1I* Ex_8Be_p7Li_trans;
-	TH1I* ThetaCM_8Be_p7Li;
-	TH1I* VCM_8Be_p7Li;
-	TH1I* cos_p7Li_thetaH;
-	TH2I* Erel_p7Li_cosThetaH;
+	FlatH1* Erel_8Be_p7Li;
+	FlatH1* Ex_8Be_p7Li;
+	FlatH1* Ex_8Be_p7Li_trans;
+	FlatH1* ThetaCM_8Be_p7Li;
+	FlatH1* VCM_8Be_p7Li;
+	FlatH1* cos_p7Li_thetaH;
+	FlatH2* Erel_p7Li_cosThetaH;
 
-	TH1I* ProtonEnergies_p7Li;
-	TH1I* LithiumEnergies_p7Li;
+	FlatH1* ProtonEnergies_p7Li;
+	FlatH1* LithiumEnergies_p7Li;
 
-	TH1I* Ex_8Be_p7Li_timegate;
+	FlatH1* Ex_8Be_p7Li_timegate;
 
-	TH1I* dTime_8Be_proton;
-	TH1I* dTime_8Be_Li7;
+	FlatH1* dTime_8Be_proton;
+	FlatH1* dTime_8Be_Li7;
 
-	TH1I* Erel_8Be_pta;
-	TH1I* Ex_8Be_pta;
-	TH1I* Ex_8Be_pta_trans;
-	TH1I* ThetaCM_8Be_pta;
-	TH1I* VCM_8Be_pta;
-	TH1I* cos_pta_thetaH;
-	TH2I* Erel_pta_cosThetaH;
+	FlatH1* Erel_8Be_pta;
+	FlatH1* Ex_8Be_pta;
+	FlatH1* Ex_8Be_pta_trans;
+	FlatH1* ThetaCM_8Be_pta;
+	FlatH1* VCM_8Be_pta;
+	FlatH1* cos_pta_thetaH;
+	FlatH2* Erel_pta_cosThetaH;
 
-	TH1I* Erel_7Li_ta_fake;
-	TH1I* Ex_7Li_ta_fake;
+	FlatH1* Erel_7Li_ta_fake;
+	FlatH1* Ex_7Li_ta_fake;
 
-	TH1I* Ex_8Be_7LiGate;
+	FlatH1* Ex_8Be_7LiGate;
 
 	// B9
-	TH1I* Erel_9B_paa;
-	TH1I* Ex_9B_paa;
-	TH1I* Ex_9B_p8Be;
-	TH1I* Ex_9B_aa;
-	TH1I* ThetaCM_9B_paa;
-	TH1I* VCM_9B_paa;
+	FlatH1* Erel_9B_paa;
+	FlatH1* Ex_9B_paa;
+	FlatH1* Ex_9B_p8Be;
+	FlatH1* Ex_9B_aa;
+	FlatH1* ThetaCM_9B_paa;
+	FlatH1* VCM_9B_paa;
 
 };
 
@@ -35,6 +35,20 @@ CLoss2::CLoss2(string filename)
 
   Emax = Ein[N-1];
 
+  // integrate 1/(dE/dx) over each segment of the table
+  range = new double [N];
+  range[0] = 0.;
+  for (int i=1;i<N;i++) range[i] = segmentRange(i-1,Ein[i]);
+
+  // third-order coefficient of the thin-absorber expansion, see getEinThin
+  thinCoef = new double [N];
+  for (int i=0;i<N-1;i++)
+  {
+    double slope = (dedx[i+1]-dedx[i])/(Ein[i+1]-Ein[i]);
+    thinCoef[i] = max(dedx[i],dedx[i+1])*slope*slope/6.;
+  }
+  thinCoef[N-1] = thinCoef[N-2];
+
 }
 
 //****************************************************************
@@ -45,43 +59,99 @@ CLoss2::~CLoss2()
 {
   delete [] Ein;
   delete [] dedx;
+  delete [] range;
+  delete [] thinCoef;
+}
+//*****************************************************************
+  /*
+   * returns the table segment i with Ein[i] <= epa < Ein[i+1]. Energies
+   * outside the table use the first or last segment, i.e. dE/dx is
+   * extrapolated linearly
+   \param epa is energy per nucleon in MeV
+   */
+int CLoss2::findSegment(double epa) const
+{
+  int i = upper_bound(Ein,Ein+N,epa) - Ein - 1;
+  return max(0,min(i,N-2));
+}
+//*****************************************************************
+  /*
+   * returns the range per nucleon at epa, integrating the linearly
+   * interpolated dE/dx of segment i from Ein[i]
+   \param i is the table segment
+   \param epa is energy per nucleon in MeV
+   */
+double CLoss2::segmentRange(int i, double epa) const
+{
+  double d0 = dedx[i];
+  double slope = (dedx[i+1]-dedx[i])/(Ein[i+1]-Ein[i]);
+  double de = epa - Ein[i];
+  if (slope == 0.) return range[i] + de/d0;
+  // d0 + slope*de can only reach zero when extrapolating far below the table
+  return range[i] + log1p(max(slope*de/d0,-1.+1e-12))/slope;
 }
 //*****************************************************************
   /*
    * returns the value of DeDx interpolated from table
    \param energy is energy of particle in MeV
    */
-float CLoss2::getDedx(float energy, float A)
+float CLoss2::getDedx(float energy, float A) const
 {
   // linear interpolation
-  int istart = 0;
-
   float epa = energy/A;
-  if (epa < Ein[0]) istart = 0;
-  else if (epa > Ein[N-1]) istart =  N-1;
-  else
-  {
-    istart = 1;
-    for (;;)
-    {
-      if (epa < Ein[istart]) break;
-      istart++;
-    }
-    istart--;
-  }
+  int istart = findSegment(epa);
 
   float de = (epa-Ein[istart])/(Ein[istart+1]-Ein[istart])
     *(dedx[istart+1]-dedx[istart]) + dedx[istart];
 
   return de;
 }
+//********************************************************************
+  /**
+   * returns the range of the particle in the absorber in mg/cm2, measured
+   * from the lowest energy per nucleon in the table
+\param energy is energy of particle in MeV
+\param A is mass of particle in amu
+  */
+float CLoss2::getRange(float energy, float A) const
+{
+  return A*rangePerNucleon(energy/A);
+}
+//********************************************************************
+  /**
+   * inverse of getRange, returns the energy of a particle with the given
+   * range in the absorber
+\param R is the range in mg/cm2 as returned by getRange
+\param A is mass of particle in amu
+  */
+float CLoss2::getEnergy(float R, float A) const
+{
+  return A*energyPerNucleon(R/A);
+}
+//********************************************************************
+double CLoss2::rangePerNucleon(double epa) const
+{
+  return segmentRange(findSegment(epa),epa);
+}
+//********************************************************************
+double CLoss2::energyPerNucleon(double rpa) const
+{
+  int i = upper_bound(range,range+N,rpa) - range - 1;
+  i = max(0,min(i,N-2));
+
+  // invert the range of segment i, d(E)/d0 = exp(slope*(r - range[i]))
+  double d0 = dedx[i];
+  double slope = (dedx[i+1]-dedx[i])/(Ein[i+1]-Ein[i]);
+  double dr = rpa - range[i];
+  return Ein[i] + ((slope == 0.) ? d0*dr : d0*expm1(slope*dr)/slope);
+}
 //********************************************************************
   /**
    * returns the residual energy of particle after passage through absorber
 \param energy is initial energy of particle in MeV
 \param thick is the thickness of the absorber in mg/cm2
   */
-float CLoss2::getEout(float energy, float thick,float A)
+float CLoss2::getEout(float energy, float thick,float A) const
 {
   if (energy > Emax)
   {
@@ -90,18 +160,7 @@ float CLoss2::getEout(float energy, float thick,float A)
     abort();
   }
   
-  float dthick = 0.1;
-  float de;
-  float Eout= energy;
-  for(;;)
-  {
-    float thickness = min(thick,dthick);
-    de = getDedx(Eout,A);
-    Eout -= de*thickness;
-    if (thickness == thick) break;
-    thick -= dthick;
-  }
-   return Eout;
+  return A*energyPerNucleon(rangePerNucleon(energy/A) - thick/A);
 }
 //********************************************************************
   /**
@@ -110,20 +169,39 @@ float CLoss2::getEout(float energy, float thick,float A)
 \param energy is the residual energy of the particle
 \param thick is the thickness of absorber through which the particle passed.
   */
-float CLoss2::getEin(float energy, float thick,float A)
+float CLoss2::getEin(float energy, float thick,float A) const
 {
-  float dthick = 0.1;
-  float de;
-  float Einput= energy;
-  for(;;)
-  {
-    float thickness = min(thick,dthick);
-    de = getDedx(Einput,A);
-    Einput += de*thickness;
-    if (thickness == thick) break;
-    thick -= dthick;
-  }
-  return Einput;
+  return A*energyPerNucleon(rangePerNucleon(energy/A) + thick/A);
 }
 
 
+//********************************************************************
+  /**
+   * Thin-absorber approximation of getEin. Within one segment of the table
+   * the energy grows as E + S*t*(1 + u/2) to second order in the thickness,
+   * with S = dE/dx at E and u = slope*t/A. The neglected terms are at most
+   * S*slope^2*t^3/(6*A^2)*exp(u), which must stay below tolerance, and the
+   * particle must not leave the segment. Returns false, leaving ein
+   * untouched, when either check fails.
+\param energy is the residual energy of the particle in MeV
+\param thick is the thickness of absorber in mg/cm2
+\param A is mass of particle in amu
+\param tolerance is the largest allowed error in MeV
+\param ein is set to the initial energy in MeV
+  */
+bool CLoss2::getEinThin(float energy, float thick, float A, float tolerance, float& ein) const
+{
+  double epa = energy/A;
+  int i = findSegment(epa);
+  double slope = (dedx[i+1]-dedx[i])/(Ein[i+1]-Ein[i]);
+  double u = slope*thick/A;
+  if (fabs(u) > 0.1) return false;
+  if (thinCoef[i]*thick*thick*thick/(A*A)*1.106 > tolerance) return false; // 1.106 > exp(0.1)
+
+  double S = dedx[i] + slope*(epa-Ein[i]);
+  double epaIn = epa + S*thick/A*(1. + 0.5*u);
+  if (i < N-2 && epaIn >= Ein[i+1]) return false;
+
+  ein = A*epaIn;
+  return true;
+}
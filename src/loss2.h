@@ -8,6 +8,12 @@ using namespace std;
 
 /**
  * !\brief energy loss of particles in an absorber
+ *
+ * dE/dx is tabulated against energy per nucleon and interpolated linearly.
+ * At load time the table is integrated exactly (for the linear
+ * interpolation) into a range-per-nucleon table r(E/A), so the energy after
+ * or before an absorber of thickness t is A*r^-1(r(E/A) -/+ t/A), i.e. two
+ * lookups instead of stepping through the absorber.
  */
 
 class CLoss2
@@ -18,13 +24,25 @@ class CLoss2
   float *dedx;
 
   float Emax;
+
+  double *range; // range per nucleon at Ein[i] in mg/cm2, measured from Ein[0]
+  double *thinCoef; // per segment, max(dE/dx)*slope^2/6 for the thin-absorber error bound
   
   CLoss2(string);
   ~CLoss2();
   
-  float getEout(float,float,float);
-  float getEin(float,float,float);
-  float getDedx(float,float);
+  float getEout(float,float,float) const;
+  float getEin(float,float,float) const;
+  float getDedx(float,float) const;
+  float getRange(float,float) const;
+  float getEnergy(float,float) const;
+  bool getEinThin(float,float,float,float,float&) const;
+
+ private:
+  int findSegment(double) const;
+  double segmentRange(int,double) const;
+  double rangePerNucleon(double) const;
+  double energyPerNucleon(double) const;
 
 
 
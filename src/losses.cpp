@@ -13,6 +13,7 @@ using namespace std;
 CLosses::CLosses(int Zmax0, SortConfig& config)
 {
   Zmax = Zmax0;
+  thinTolerance = 0.001;
   string path = config.GetLossDir();
   string suffix = "_" + config.GetTargetSuffix() + ".loss";
   string filename;
@@ -49,20 +50,49 @@ CLosses::~CLosses()
 
 
 //**********************************************************
-float CLosses::getEin(float energy, float thick,int Z,float A)
+float CLosses::getEin(float energy, float thick,int Z,float A) const
 {
   if (Z > Zmax)
   {
     cout << " no loss info for Z = " << Z << endl;
     abort();
   }
-  float energyi = loss[Z]->getEin(energy,thick, A);
+  // most particles lose little energy in the target, use the closed form
+  // when its error bound allows and integrate through the tables otherwise
+  float energyi;
+  if (!loss[Z]->getEinThin(energy,thick,A,thinTolerance,energyi))
+    energyi = loss[Z]->getEin(energy,thick, A);
 
 
   return energyi;
 }
 //**********************************************************
-float CLosses::getEout(float energy, float thick,int Z,float A)
+  /**
+   * getEin for n particles at once, e.g. all identified particles of an
+   * event, with the Z check done once for the batch
+\param n is the number of particles
+\param energy, thick, Z and A are the arguments of getEin for each particle
+\param ein is filled with the n initial energies
+  */
+void CLosses::getEin(int n, const float* energy, const float* thick, const int* Z, const float* A, float* ein) const
+{
+  for (int i=0;i<n;i++)
+  {
+    if (Z[i] > Zmax)
+    {
+      cout << " no loss info for Z = " << Z[i] << endl;
+      abort();
+    }
+  }
+
+  for (int i=0;i<n;i++)
+  {
+    if (!loss[Z[i]]->getEinThin(energy[i],thick[i],A[i],thinTolerance,ein[i]))
+      ein[i] = loss[Z[i]]->getEin(energy[i],thick[i],A[i]);
+  }
+}
+//**********************************************************
+float CLosses::getEout(float energy, float thick,int Z,float A) const
 {
     if (Z > Zmax)
     {
@@ -8,11 +8,13 @@ class CLosses
  private:
    CLoss2 ** loss;
    int Zmax;
+   float thinTolerance; // largest error in MeV accepted from the thin-absorber approximation
  public:
    CLosses(int,SortConfig&);
    ~CLosses();
-   float getEin(float,float,int,float);
-   float getEout(float,float,int,float);
+   float getEin(float,float,int,float) const;
+   void getEin(int,const float*,const float*,const int*,const float*,float*) const;
+   float getEout(float,float,int,float) const;
 
 };
 
@@ -7,17 +7,21 @@
 
 #include "pid.h"
 
+#include <algorithm>
+#include <exception>
 #include <fstream>
 #include <iostream>
 
+#include <stuffing.hpp>
+
 using namespace std;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-pid::pid(string file, SortConfig& config) : Z(-1), A(-1) {
+pid::pid(string file, const string& dir) {
 
 	// Open zline file
-	string name = config.GetPIDDir() + file + ".zline";
+	string name = dir + file + ".zline";
 	ifstream ifile(name.c_str());
 	if (!ifile.is_open()) {
 		cout << "could not open zline file " << name << endl;
@@ -31,6 +35,23 @@ pid::pid(string file, SortConfig& config) : Z(-1), A(-1) {
 		par[i] = new ZApar(ifile);
 	ifile.close();
 	ifile.clear();
+
+	BuildGrid();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+pid::pid(const GateCache& cache, string file) {
+	const GateCache::Gate* gates = cache.GetGates(file, nlines);
+	if (!gates) throw invalid_argument(string(BOLDRED) + string("zline file ") + file + string(" is not in the PID gate cache") + string(RESET));
+
+	par = new ZApar*[nlines];
+	for (int i = 0; i < nlines; i++) {
+		const GateCache::Gate& g = gates[i];
+		par[i] = new ZApar(g.Z, g.A, g.npoints, cache.GetX() + g.firstPoint, cache.GetY() + g.firstPoint);
+	}
+
+	BuildGrid();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -43,27 +64,148 @@ pid::~pid() {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 /* Returns true if particle is in a banana gate, false otherwise. The parameters
- * Z and A are loaded with the detected particle's values.
+ * Z, A and mass are loaded with the detected particle's values. As before,
+ * the first gate in the file that contains the point wins.
  * \param x energy of particle
  * \param y energy loss of particle
  */
-bool pid::getPID(float x, float y) {
+bool pid::getPID(float x, float y, int& Z, int& A, float& mass) const {
 	Z = 0;
 	A = 0;
+	if (cellGate.empty()) return false;
+
+	// Outside the grid means outside every gate (also catches NaN)
+	float fx = (x - gridX0) * gridInvDX;
+	float fy = (y - gridY0) * gridInvDY;
+	if (!(fx >= 0 && fx < gridN && fy >= 0 && fy < gridN)) return false;
+
+	int cell = int(fy) * gridN + int(fx);
+	short gate = cellGate[cell];
+	if (gate == NoGate) return false;
+	if (gate >= 0) return SetResult(gate, Z, A, mass);
+
+	// Cell crossed by gate edges, test the candidate gates in order
+	for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+		int i = cellCandidates[k];
+		if (x < gateXmin[i] || x > gateXmax[i] || y < gateYmin[i] || y > gateYmax[i]) continue;
+		if (par[i]->inBanana(x,y)) return SetResult(i, Z, A, mass);
+	}
+	return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool pid::SetResult(int gate, int& Z, int& A, float& mass) const {
+	Z = par[gate]->Z;
+	A = par[gate]->A;
+	mass = (gateMass[gate] >= 0) ? gateMass[gate] : getMass(Z,A); // getMass aborts for unknown masses
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// True if the segment (x0,y0)-(x1,y1) touches the rectangle, by clipping
+// the segment against each side (Liang-Barsky)
+static bool SegmentTouchesRect(float x0, float y0, float x1, float y1, float rx0, float ry0, float rx1, float ry1) {
+	float t0 = 0, t1 = 1;
+	float dx = x1 - x0, dy = y1 - y0;
+	float p[4] = {-dx, dx, -dy, dy};
+	float q[4] = {x0 - rx0, rx1 - x0, y0 - ry0, ry1 - y0};
+	for (int k = 0; k < 4; k++) {
+		if (p[k] == 0) {
+			if (q[k] < 0) return false;
+			continue;
+		}
+		float t = q[k] / p[k];
+		if (p[k] < 0) t0 = max(t0, t);
+		else t1 = min(t1, t);
+		if (t0 > t1) return false;
+	}
+	return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void pid::BuildGrid() {
+	if (nlines == 0) return;
+
+	// Bounding box of each gate and of all of them
+	float xmin = 1e30, xmax = -1e30, ymin = 1e30, ymax = -1e30;
 	for (int i = 0; i < nlines; i++) {
-		if (par[i]->inBanana(x,y)) {
-			Z = par[i]->Z;
-			A = par[i]->A;
-			mass = getMass(Z,A);
-			return true;
+		const ZApar* g = par[i];
+		auto mapEntry = Mass_lookup.find({g->Z, g->A});
+		gateMass.push_back(mapEntry == Mass_lookup.end() ? -1.f : mapEntry->second);
+
+		// A gate without points contains nothing, give it an empty box so no
+		// cell or point ever tests it
+		if (g->n == 0) {
+			gateXmin.push_back(1e30);
+			gateXmax.push_back(-1e30);
+			gateYmin.push_back(1e30);
+			gateYmax.push_back(-1e30);
+			continue;
 		}
+		gateXmin.push_back(*min_element(g->x, g->x + g->n));
+		gateXmax.push_back(*max_element(g->x, g->x + g->n));
+		gateYmin.push_back(*min_element(g->y, g->y + g->n));
+		gateYmax.push_back(*max_element(g->y, g->y + g->n));
+		xmin = min(xmin, gateXmin[i]);
+		xmax = max(xmax, gateXmax[i]);
+		ymin = min(ymin, gateYmin[i]);
+		ymax = max(ymax, gateYmax[i]);
 	}
-	return false;
+	if (xmin > xmax) return; // every gate is empty, cellGate stays empty
+
+	float padX = 1e-3f * (xmax - xmin) + 1e-6f;
+	float padY = 1e-3f * (ymax - ymin) + 1e-6f;
+	gridX0 = xmin - padX;
+	gridY0 = ymin - padY;
+	float dx = (xmax - xmin + 2 * padX) / gridN;
+	float dy = (ymax - ymin + 2 * padY) / gridN;
+	gridInvDX = 1 / dx;
+	gridInvDY = 1 / dy;
+
+	// Classify every cell. The cell is grown slightly so that rounding in
+	// getPID can not put a point just outside the cell it was classified for.
+	cellGate.assign(gridN * gridN, NoGate);
+	cellStart.assign(gridN * gridN + 1, 0);
+	for (int iy = 0; iy < gridN; iy++) {
+		for (int ix = 0; ix < gridN; ix++) {
+			int cell = iy * gridN + ix;
+			float rx0 = gridX0 + ix * dx - 1e-3f * dx, rx1 = gridX0 + (ix + 1) * dx + 1e-3f * dx;
+			float ry0 = gridY0 + iy * dy - 1e-3f * dy, ry1 = gridY0 + (iy + 1) * dy + 1e-3f * dy;
+			float cx = gridX0 + (ix + 0.5f) * dx, cy = gridY0 + (iy + 0.5f) * dy;
+
+			cellStart[cell] = cellCandidates.size();
+			bool edges = false;
+			for (int i = 0; i < nlines; i++) {
+				if (rx1 < gateXmin[i] || rx0 > gateXmax[i] || ry1 < gateYmin[i] || ry0 > gateYmax[i]) continue;
+
+				const ZApar* g = par[i];
+				bool crossed = false;
+				for (int k = 0, j = g->n - 1; k < g->n && !crossed; j = k++)
+					crossed = SegmentTouchesRect(g->x[j], g->y[j], g->x[k], g->y[k], rx0, ry0, rx1, ry1);
+
+				if (crossed) {
+					cellCandidates.push_back(i);
+					edges = true;
+				}
+				else if (g->inBanana(cx, cy)) {
+					// The whole cell is inside this gate, later gates can not win
+					if (edges) cellCandidates.push_back(i);
+					else cellGate[cell] = i;
+					break;
+				}
+			}
+			if (edges) cellGate[cell] = EdgeCell;
+		}
+	}
+	cellStart[gridN * gridN] = cellCandidates.size();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-float pid::getMass(int iZ,int iA) {
+float pid::getMass(int iZ,int iA) const {
 	auto mapEntry = Mass_lookup.find({iZ, iA});
 	if (mapEntry == Mass_lookup.end()) {
 		cout << "No mass info for Z = "<< iZ << " A =" << iA << endl;
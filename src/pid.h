@@ -6,28 +6,52 @@
  * 
  * Modified by Henry Webb (h.s.webb@wustl.edu), September 2025.
  * Mass values no longer hardcoded, now retrieved from std::unordered_map. 
+ *
+ * getPID no longer stores its result in the class, so a single pid object
+ * can be shared read-only between worker threads.
+ *
+ * The gates are rasterized once into a grid over the E-DE plane. Cells that
+ * lie entirely inside (or outside) the gates give the result with a single
+ * lookup, only cells crossed by a gate edge do the exact point-in-polygon
+ * test, and only for the gates that cross them, in the original order.
  */
 
 #include <string>
+#include <vector>
 
 #include "constants.h"
+#include "GateCache.h"
 #include "ZApar.h"
 #include "SortConfig.h"
 
 class pid {
 
 public:
-	pid(std::string file,SortConfig&); 
+	pid(std::string file, const std::string& dir); // reads dir + file + ".zline"
+	pid(const GateCache& cache, std::string file); // gates point into the cache, which must outlive this object
 	~pid();
 
-	bool getPID(float x, float y);
-  float getMass(int iZ,int iA);
+	bool getPID(float x, float y, int& Z, int& A, float& mass) const;
+	float getMass(int iZ,int iA) const;
 
 	ZApar** par; // individual banana gates
 	int nlines;  // number of banana gated stored 	
-	int Z;       // Z of particle in gate
-	int A;       // A of particle in gate
-	float mass;  // mass of particle in amu
+
+private:
+	static constexpr int gridN = 128;      // grid cells along each axis
+	static constexpr short NoGate = -1;    // cell outside all gates
+	static constexpr short EdgeCell = -2;  // cell needs the exact test
+
+	float gridX0, gridY0;              // lower edge of the grid
+	float gridInvDX, gridInvDY;        // inverse cell size
+	std::vector<short> cellGate;       // gate index, NoGate or EdgeCell
+	std::vector<int> cellStart;        // candidate gates of cell i are cellCandidates[cellStart[i]..cellStart[i+1])
+	std::vector<short> cellCandidates;
+	std::vector<float> gateXmin, gateXmax, gateYmin, gateYmax; // bounding box of each gate
+	std::vector<float> gateMass;       // mass of each gate, < 0 if unknown
+
+	void BuildGrid();
+	bool SetResult(int gate, int& Z, int& A, float& mass) const;
 
 };
 
@@ -6,11 +6,13 @@ using namespace std;
 
 //**********************************************************
   //constructor
-silicon::silicon(float thick0, SortConfig& config)
+silicon::silicon(float thick0, const CLosses* losses0, SolutionArena* arena0)
 {
   TargetThickness = thick0;
   SiWidth = 6.45;
-  losses = new CLosses(3, config);
+  losses = losses0;
+  arena = arena0;
+  Solution = arena->alloc(0);
   Ran = new TRandom();
 }
 
@@ -18,13 +20,11 @@ silicon::silicon(float thick0, SortConfig& config)
 //destructor
 silicon::~silicon()
 {
-  delete losses;
   delete Ran;
-  delete Pid;
 }
 
 //inialization
-void silicon::init(int id0, SortConfig& config)
+void silicon::init(int id0, const pid* Pid0, const LinearPID* LinPid0)
 {
   id = id0;
   //-ND checked 5/12/2022 these distances are correct compared to the simulation
@@ -33,17 +33,13 @@ void silicon::init(int id0, SortConfig& config)
   Xcenter = XcenterA[id];
   Ycenter = YcenterA[id];
 
-
-  ostringstream outstring;  
-  outstring << "pid_quad" << id+1;
-
-  Pid = new pid(outstring.str(),config);
-
+  Pid = Pid0;
+  LinPid = LinPid0;
 }
 
 void silicon::SetTargetDistance(double dist)
 {
-  for (int i=0;i<20;i++) Solution[i].SetTargetDistance(dist);
+  arena->SetTargetDistance(dist);
 }
 
 
@@ -60,9 +56,8 @@ void silicon::reset()
   Front.reset();
   Back.reset();
   Delta.reset();
-	if (Nsolution > 100) cout << "here post F,B,D reset, need to reset " << Nsolution << " solutions" << endl;
-  for (int i=0; i<Nsolution; i++){ Solution[i].reset();}
-	//cout << "here post solution reset" << endl;
+  //solutions are reset when the arena hands them out
+  Solution = arena->alloc(0);
   Nsolution = 0;
 }
 
@@ -99,7 +94,13 @@ int silicon::simpleFront()
   //  return 0;
   //}
 
-
+  Solution = arena->alloc(1);
+  if (Solution == nullptr)
+  {
+    Solution = arena->alloc(0);
+    Nsolution = 0;
+    return 0;
+  }
 
   Solution[0].energy = Front.Order[0].energy;
   Solution[0].energyR = Front.Order[0].energyR;
@@ -141,21 +142,58 @@ int silicon::getPID()
     float energy = Solution[isol].energy;
     float denergy = Solution[isol].denergy*cos(Solution[isol].theta);
 
-    bool FoundPid = Pid->getPID(energy, denergy);
+    int Z, A;
+    float mass;
+    bool FoundPid;
+    if (LinPid)
+    {
+      Solution[isol].pidValue = LinPid->getValue(id, energy, Solution[isol].denergy, cos(Solution[isol].theta));
+      FoundPid = LinPid->getPID(Solution[isol].pidValue, Z, A, mass);
+    }
+    else FoundPid = Pid->getPID(energy, denergy, Z, A, mass);
 
     //no particle id is found
     if (!FoundPid) continue;
     else pidmulti++;
 
     Solution[isol].ipid = 1; //this can be adapted to be different values later
-    Solution[isol].iZ = Pid->Z;
-    Solution[isol].iA = Pid->A;
-    Solution[isol].mass = Pid->mass;
+    Solution[isol].iZ = Z;
+    Solution[isol].iA = A;
+    Solution[isol].mass = mass;
   }
   return pidmulti;
 }
 
 int silicon::calcEloss()
+{
+  float energy[MaxSolution], thick[MaxSolution], A[MaxSolution], ein[MaxSolution];
+  int Z[MaxSolution];
+  int n = fillEloss(energy,thick,Z,A);
+  losses->getEin(n,energy,thick,Z,A,ein);
+  return applyEloss(ein);
+}
+//****************************************************
+//fills the energy loss inputs of the solutions calcEloss corrects, i.e.
+//all solutions up to the first one without PID. Returns their number.
+int silicon::fillEloss(float* energy, float* thick, int* Z, float* A) const
+{
+  int n = 0;
+  while (n < Nsolution && Solution[n].ipid) n++;
+
+  for (int isol=0; isol<n; isol++)
+  {
+    //add Delta and energy for total energy
+    energy[isol] = Solution[isol].denergy + Solution[isol].energy;
+    thick[isol] = TargetThickness/2/cos(Solution[isol].theta);
+    Z[isol] = Solution[isol].iZ;
+    A[isol] = Solution[isol].mass/m0;
+  }
+  return n;
+}
+//****************************************************
+//sets Ekin and momentum of the solutions from the corrected energies
+//of fillEloss, with the punch-through checks of calcEloss
+int silicon::applyEloss(const float* ein)
 {
   for (int isol=0; isol<Nsolution; isol++)
   {
@@ -166,18 +204,9 @@ int silicon::calcEloss()
       return 0;
     }
 
-    //kinetics calc, add Delta and energy for total energy
-    float sumEnergy = Solution[isol].denergy + Solution[isol].energy;
-    float pc_before = sqrt(pow(sumEnergy+Solution[isol].mass,2) - pow(Solution[isol].mass,2));
-    float velocity_before = pc_before/(sumEnergy+Solution[isol].mass);
-
-    float thick = TargetThickness/2/cos(Solution[isol].theta);
+    //out << "loss correction " << ein[isol] - sumEnergy << endl;
 
-    float ein = losses->getEin(sumEnergy,thick,Solution[isol].iZ,Solution[isol].mass/m0);
-
-    //out << "loss correction " << ein - sumEnergy << endl;
-
-    Solution[isol].Ekin = ein;
+    Solution[isol].Ekin = ein[isol];
     //calc momentum vector, energyTot, and velocity
     Solution[isol].getMomentum();
 
@@ -230,55 +259,38 @@ int silicon::calcEloss()
 
 
 //****************************************************
-//recursive subroutine  used for multihit subroutine
-void silicon::loop(int depth)
+//finds the assignments of columns to rows with the smallest total cost,
+//where cost[i*n+j] is the cost of pairing row i with column j. Costs are
+//added row by row and among equal totals the lexicographically first
+//assignment is kept, as in the old permutation search. Bitmask dynamic
+//programming, O(n^2 2^n) instead of n! permutations.
+//best[mask] is the smallest cost of rows 0..popcount(mask)-1 using the
+//columns in mask, first[mask] the columns they use, 3 bits per row with
+//row 0 in the highest bits so that smaller means lexicographically first.
+//The best assignment of the first d rows and columns is therefore
+//first[(1<<d)-1], for every d <= n.
+void silicon::assign(int n, const float* cost, float* best, int* first)
 {
-
-  if (depth == NestDim) //depth starts at 0
-  {
-    int dstrip = 0;
-    float de = 0.;
-    for (int i=0;i<NestDim;i++)
-    {
-      dstrip += abs(Delta.Order[NestArray[i]].strip
-            -Front.Order[i].strip);
-      de += abs(Back.Order[NestArray[i]].energy
-            -Front.Order[i].energy);
-    }
-
-    //cout << " 1 " << zline[0].n << endl;
-
-    if (dstrip < dstripMin)
-    {
-      dstripMin = dstrip;
-      for (int i=0;i<NestDim;i++) {arrayD[i] = NestArray[i];}
-    }
-    //cout << " 2 " << zline[0].n << endl;
-
-    if (de < deMin)
-    {
-      deMin = de;
-      for (int i=0;i<NestDim;i++) {arrayB[i] = NestArray[i];}
-    }
-    //cout << "leave" << " " << zline[0].n << endl;
-    return;
-  }
-
-  //cout << "recurse " << zline[0].n << endl;
-  for (int i=0;i<NestDim;i++)
+  best[0] = 0.;
+  first[0] = 0;
+  int full = (1<<n) - 1;
+  for (int mask=1;mask<=full;mask++)
   {
-    NestArray[depth] = i;
-    int leave = 0;
-    for (int j=0;j<depth;j++)
+    const float* row = cost + (__builtin_popcount(mask) - 1)*n;
+    float bmin = 1.e30;
+    int fmin = 0;
+    for (int rest=mask;rest;rest&=rest-1) //columns in mask
     {
-      if (NestArray[j] == i)
-      {
-        leave =1;
-        break; 
-      }
+      int j = __builtin_ctz(rest);
+      int prev = mask & ~(1<<j);
+      float b = best[prev] + row[j];
+      int f = (first[prev]<<3) | j;
+      bool better = b < bmin || (b == bmin && f < fmin);
+      bmin = better ? b : bmin;
+      fmin = better ? f : fmin;
     }
-    if (leave) continue;
-    loop(depth+1);
+    best[mask] = bmin;
+    first[mask] = fmin;
   }
 }
 
@@ -289,17 +301,38 @@ int silicon::multiHit()
   int Ntries = min(Front.Nstore,Back.Nstore);
   Ntries = min(Ntries,Delta.Nstore);
 
-  if (Ntries > 4) Ntries =4;
+  if (Ntries > MaxMatch) Ntries = MaxMatch;
   Nsolution = 0;
   if (Ntries <= 0) return 0;
-  
-  for (NestDim = Ntries;NestDim>0;NestDim--)
+
+  //Delta strips are matched to the front by strip number and back strips
+  //by energy, for all numbers of particles at once
+  float costD[MaxMatch*MaxMatch];
+  float costB[MaxMatch*MaxMatch];
+  for (int i=0;i<Ntries;i++)
   {
-    dstripMin = 1000;
-    deMin = 10000.;
-    
-    //look for best solution
-    loop(0);
+    for (int j=0;j<Ntries;j++)
+    {
+      costD[i*Ntries+j] = abs(Delta.Order[j].strip - Front.Order[i].strip);
+      costB[i*Ntries+j] = fabs(Back.Order[j].energy - Front.Order[i].energy);
+    }
+  }
+  float bestD[1<<MaxMatch], bestB[1<<MaxMatch];
+  int firstD[1<<MaxMatch], firstB[1<<MaxMatch];
+  assign(Ntries,costD,bestD,firstD);
+  assign(Ntries,costB,bestB,firstB);
+
+  int arrayD[MaxMatch];
+  int arrayB[MaxMatch];
+  for (int NestDim = Ntries;NestDim>0;NestDim--)
+  {
+    //best solution with NestDim particles
+    int mask = (1<<NestDim) - 1;
+    for (int i=0;i<NestDim;i++)
+    {
+      arrayD[i] = (firstD[mask]>>(3*(NestDim-1-i))) & 7;
+      arrayB[i] = (firstB[mask]>>(3*(NestDim-1-i))) & 7;
+    }
     
     //check to see if best possible solution is reasonable
     int leave = 0;
@@ -325,6 +358,12 @@ int silicon::multiHit()
       
     if (leave) continue;
     // now load solution
+    Solution = arena->alloc(NestDim);
+    if (Solution == nullptr)
+    {
+      Solution = arena->alloc(0);
+      return 0;
+    }
     for (int i=0;i<NestDim;i++)
     {
       float timediff = Front.Order[i].time - Delta.Order[arrayD[i]].time;
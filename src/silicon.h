@@ -11,8 +11,8 @@
 #include "elist.h"
 #include "solution.h"
 #include "pid.h"
+#include "LinearPID.h"
 #include "losses.h"
-#include "SortConfig.h"
 using namespace std;
 
 /*
@@ -28,18 +28,20 @@ struct lines
 class silicon
 {
  public:
-  silicon(float, SortConfig&);
+  silicon(float, const CLosses*, SolutionArena*);
   ~silicon();
   void reset();
-  void init(int, SortConfig&);
+  void init(int, const pid*, const LinearPID*);
   void Reduce();
   int simpleFront();
   int multiHit();
   void SetTargetDistance(double);
   int getPID();
   int calcEloss();
+  int fillEloss(float*, float*, int*, float*) const;
+  int applyEloss(const float*);
 
-  CLosses * losses;
+  const CLosses * losses; // shared, owned by AnalysisContext
   float TargetThickness;
 
   int id;
@@ -57,10 +59,14 @@ class silicon
   elist Back;
   elist Delta;
 
-  solution Solution[20];
+  static const int MaxSolution = 20;
+  static const int MaxMatch = 8; // most hits per face matched by multiHit
+  solution * Solution; // this event's solutions, in the event's arena
   int Nsolution = 0;
+  SolutionArena * arena; // shared by the four telescopes, owned by Gobbi
 
-  pid * Pid;
+  const pid * Pid; // shared, owned by AnalysisContext
+  const LinearPID * LinPid; // shared, nullptr unless pidMode = linear
 
   int simpleFrontBack();
   void position(int);
@@ -78,14 +84,8 @@ class silicon
   float SiWidth;
   TRandom *Ran;
 
-  //for nested loops
-  int NestDim;
-  void loop(int);
-  int NestArray[50];
-  int arrayD[50];
-  int arrayB[50];
-  float deMin;
-  int dstripMin;
+  //matching of Delta and Back strips to Front strips in multiHit
+  static void assign(int, const float*, float*, int*);
 
 };
 #endif
@@ -7,6 +7,26 @@
 
 using namespace std;
 
+#ifdef rel
+CEinstein solution::Kinematics;
+#else
+CNewton solution::Kinematics;
+#endif
+
+//********************************************************
+solution* SolutionArena::alloc(int n)
+{
+  if (used + n > Capacity) return nullptr;
+  solution* first = pool + used;
+  for (int i=0;i<n;i++)
+  {
+    first[i].reset();
+    first[i].SetTargetDistance(distTarget);
+  }
+  used += n;
+  return first;
+}
+
 void solution::reset()
 {
   energy = -1;
@@ -32,6 +52,7 @@ void solution::reset()
   iZ = 0;
   iA = 0;
   mass = 0;
+  pidValue = 0;
   
   //variables filled after position() and calcEloss() from Silicon.cpp
   Xpos = -1;
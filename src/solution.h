@@ -20,10 +20,11 @@
 class solution
 {
   public:
+  //stateless, so one helper is shared by all solutions
 #ifdef rel
-  CEinstein Kinematics;
+  static CEinstein Kinematics;
 #else
-  CNewton Kinematics;
+  static CNewton Kinematics;
 #endif
 
   float distTarget;
@@ -54,6 +55,7 @@ class solution
   int iZ;
   int iA;
   float mass;
+  float pidValue; // continuous PID value, only with pidMode = linear
   
   //variables filled after position() and calcEloss() from Silicon.cpp
   float Xpos;
@@ -91,5 +93,30 @@ class solution
   void getMomentum();
 };
 
+/**
+ * !\brief per-event storage for the solutions of all telescopes
+ *
+ * Each telescope takes as many records as it finds particles, one after the
+ * other, so the solutions of an event sit together in memory. Records are
+ * reset when they are handed out and the whole arena is emptied once per
+ * event by resetting the fill counter. Pointers to records (e.g. in correl2
+ * and parType) are valid until the next reset.
+ */
+class SolutionArena
+{
+  public:
+  static const int Capacity = 80; // four telescopes of silicon::MaxSolution
+
+  //returns n reset records, or nullptr if the arena is full
+  solution* alloc(int n);
+  void reset() { used = 0; }
+  void SetTargetDistance(double dist0) { distTarget = dist0; }
+
+  private:
+  solution pool[Capacity];
+  int used = 0;
+  double distTarget = 0.;
+};
+
 
 #endif
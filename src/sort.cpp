@@ -5,22 +5,32 @@
 // (i.e. SpecTcl now does the unpacking). Uses TNLIB TexNeut analysis
 // library written by Alex Alafa.
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <exception>
+#include <filesystem>
+#include <functional>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <ROOT/TBufferMerger.hxx>
+#include <ROOT/TSeq.hxx>
+#include <ROOT/TThreadExecutor.hxx>
 #include <ROOT/TTreeProcessorMT.hxx>
+#include <TEntryList.h>
 #include <TH1I.h>
+#include <TROOT.h>
 #include <TFile.h>
 #include <TTree.h>
 
@@ -30,22 +40,114 @@
 #include <stuffing.hpp>
 #include <tof_needs.hpp>
 
+#include "AnalysisContext.h"
+#include "EventIndex.h"
+#include "HistStore.h"
 #include "Gobbi.h"
 #include "histo.h"
+#include "HitList.h"
 #include "Input.h"
+#include "RawPipeline.h"
 #include "SortConfig.h"
+#include "ThreadLayout.h"
 
 #include "constants.h"
 
 using namespace std;
 
-int main() {
+// Create an output directory if it does not exist yet, key is the config entry it comes from
+static void MakeOutputDir(const string& dir, const string& key) {
+	error_code ec;
+	filesystem::create_directories(dir, ec);
+	if (ec) throw invalid_argument(string(BOLDRED) + string("Cannot create ") + key + string(" ") + dir + string(": ") + ec.message() + string(RESET));
+}
+
+// Print command-line usage
+static void PrintUsage(const char* prog) {
+	cout << "Usage: " << prog << " [options]" << endl;
+	cout << "  -c, --config <file>  sort config file (default ../config/sort.config)" << endl;
+	cout << "  -j, --threads <n>    number of worker threads, 0 for one per selected CPU" << endl;
+	cout << "      --cpus <list>    CPUs the workers may use, e.g. 0-15,32-47" << endl;
+	cout << "      --numa <node>    bind workers and memory to a NUMA node, -1 to disable" << endl;
+	cout << "      --pin / --no-pin pin each worker thread to its own CPU" << endl;
+	cout << "      --convert        write zero-suppressed hit-list files to hitListDir and exit" << endl;
+	cout << "      --write-index    write an event index for each run to indexDir" << endl;
+	cout << "      --select <tags>  only sort indexed events carrying all tags, e.g. p,a,n" << endl;
+	cout << "  -h, --help           show this message" << endl;
+}
+
+int main(int argc, char* argv[]) {
 
 	// Capture the start time
 	auto start = chrono::high_resolution_clock::now();
+
+	// Find the config file first, since the other command-line options override its values
+	string configPath = "../config/sort.config";
+	for (int i = 1; i < argc - 1; i++) {
+		string arg = argv[i];
+		if (arg == "-c" || arg == "--config") configPath = argv[i + 1];
+	}
 	
 	// Load config file for sort code
-	SortConfig sortConfig("../config/sort.config");
+	SortConfig sortConfig(configPath);
+
+	// Apply command-line overrides
+	bool convert = false;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if (arg == "-h" || arg == "--help") {
+			PrintUsage(argv[0]);
+			return 0;
+		}
+		else if ((arg == "-c" || arg == "--config") && hasValue) i++;
+		else if ((arg == "-j" || arg == "--threads") && hasValue) {
+			string value = argv[++i];
+			try {
+				size_t pos;
+				if (value.empty() || value[0] == '-') throw invalid_argument(value); // stoul would wrap negative values
+				size_t nthreads = stoul(value, &pos);
+				if (pos != value.size()) throw invalid_argument(value);
+				sortConfig.SetNThreads(nthreads);
+			}
+			catch (...) {
+				cerr << "Invalid thread count " << value << ", must be an unsigned integer" << endl;
+				PrintUsage(argv[0]);
+				return 1;
+			}
+		}
+		else if (arg == "--cpus" && hasValue) sortConfig.SetCPUList(argv[++i]);
+		else if (arg == "--numa" && hasValue) {
+			string value = argv[++i];
+			try {
+				size_t pos;
+				int numaNode = stoi(value, &pos);
+				if (pos != value.size()) throw invalid_argument(value);
+				sortConfig.SetNumaNode(numaNode);
+			}
+			catch (...) {
+				cerr << "Invalid NUMA node " << value << ", must be an integer" << endl;
+				PrintUsage(argv[0]);
+				return 1;
+			}
+		}
+		else if (arg == "--pin") sortConfig.SetPinThreads(true);
+		else if (arg == "--no-pin") sortConfig.SetPinThreads(false);
+		else if (arg == "--convert") convert = true;
+		else if (arg == "--write-index") sortConfig.SetWriteIndex(true);
+		else if (arg == "--select" && hasValue) sortConfig.SetIndexSelect(argv[++i]);
+		else {
+			cerr << "Unknown or incomplete option " << arg << endl;
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	// Choose worker threads, CPUs and NUMA node, and restrict the process to them
+	// before the ROOT thread pool is created so that its workers inherit the settings
+	ThreadLayout layout(sortConfig.GetNThreads(), sortConfig.GetCPUList(), sortConfig.GetNumaNode(), sortConfig.GetPinThreads());
+	layout.Apply();
+	layout.Report(cout);
 	
 	// Setup for multi-threaded progress bar
 	const size_t updateRate = sortConfig.GetUpdateRate();
@@ -57,18 +159,95 @@ int main() {
 	detector texneut;
 	texneut.fillmaps(configFile.GetExpInfoDir(), configFile.GetBarMapFile(), configFile.GetPosMapFile(), configFile.GetGainFile());
 
+	// Read the list of runs to sort
+	string runNumbersFile = sortConfig.GetRunNumbersFile();
+	ifstream runFile(runNumbersFile);
+	if (runFile.fail()) throw invalid_argument(string(BOLDRED) + string("Run numbers file ") + runNumbersFile + std::string(" does not exist or failed to open") + std::string(RESET));
+	vector<int> runNumbers;
+	for (int run; runFile >> run;) runNumbers.push_back(run);
+
+	// Input mode used to read the SpecTcl files, and where the hit-list files live
+	const Input::Mode inputMode = Input::ParseMode(sortConfig.GetInputMode());
+	const string hitListDir = sortConfig.GetHitListDir().empty() ? configFile.GetTNDataDir() : sortConfig.GetHitListDir();
+
+	/******** CONVERSION TO HIT-LIST FILES ********/
+
+	// Convert each SpecTcl run file once into a compact hit-list file. Runs are
+	// converted in parallel, each by a single thread so that entry order is kept.
+	if (convert) {
+		const Input::Mode sourceMode = (inputMode == Input::Mode::Sparse || inputMode == Input::Mode::Raw) ? Input::Mode::Bulk : inputMode;
+		const string itname = sortConfig.GetItreeName();
+		MakeOutputDir(hitListDir, "hitListDir");
+		cout << "Converting " << runNumbers.size() << " runs to hit-list files in " << hitListDir << endl;
+
+		ROOT::EnableThreadSafety();
+		ROOT::TThreadExecutor pool(layout.GetNThreads());
+		pool.Foreach([&](size_t irun) {
+			layout.PinCurrentThread();
+			int run = runNumbers[irun];
+			string infile = configFile.GetTNDataDir() + "run-" + to_string(run) + ".root";
+			string outfile = hitListDir + HitList::FileName(run);
+			try {
+				size_t nevents = HitList::Convert(infile, itname, outfile, sourceMode);
+				lock_guard<mutex> lock(consoleMutex);
+				cout << "Run " << run << ": " << nevents << " events written to " << outfile << endl;
+			}
+			catch (const exception& e) {
+				lock_guard<mutex> lock(consoleMutex);
+				cerr << e.what() << endl;
+			}
+		}, ROOT::TSeqUL(runNumbers.size()));
+		return 0;
+	}
+
+	// Load calibrations, PID gates and energy loss tables once, shared read-only by all tasks
+	AnalysisContext context(sortConfig);
+
+	// Load the calibration set of every run now, so a bad entry or file stops the job before sorting starts
+	context.GetCalibrations()->Preload(runNumbers);
+
+	// Declare the spectra, each thread stores its own bin contents for the whole job
+	HistStore::Load(sortConfig.GetSpectraFile(), sortConfig.GetDisableSpectra());
+
 	// Create the TBufferMerger: this class orchestrates the parallel writing to an output ROOT file
 	string ofname = configFile.GetOutputDir() + sortConfig.GetOfileName();
-	ROOT::TBufferMerger merger(ofname.c_str(), "RECREATE");
+	auto merger = make_unique<ROOT::TBufferMerger>(ofname.c_str(), "RECREATE");
 	cout << GREEN << "Output file: " << ofname << RESET << endl;
 
 	// Enable implicit multi-threading
-	int nthreads = 4;
-	ROOT::EnableImplicitMT(nthreads);
+	ROOT::EnableImplicitMT(layout.GetNThreads());
 	
 	// Initialize some variables up here so that they are accessible inside the lambda function
-	int runnum;
+	int runnum = -1;
 	size_t numentries = 0;
+	const bool globalScheduler = sortConfig.IsGlobalScheduler();
+
+	// Input file of each run that is sorted, and its run number
+	vector<string> runFiles;
+	vector<int> runFileRuns;
+
+	// Event index settings. An index is only written from a full sort, since a
+	// selected sort would overwrite it with the selected events only.
+	const string indexDir = sortConfig.GetIndexDir().empty() ? hitListDir : sortConfig.GetIndexDir();
+	const uint32_t selectMask = EventIndex::ParseTags(sortConfig.GetIndexSelect());
+	bool writeIndex = sortConfig.GetWriteIndex();
+	if (writeIndex && selectMask != 0) {
+		cerr << "Event index is not written when sorting a selection of events" << endl;
+		writeIndex = false;
+	}
+	EventIndex::Builder indexBuilder;
+
+	// Raw input streams NSCLDAQ event files through RawUnpacker instead of reading ROOT trees
+	const bool rawInput = (inputMode == Input::Mode::Raw);
+	const string rawDataDir = sortConfig.GetRawDataDir();
+	if (rawInput && (selectMask != 0 || writeIndex)) {
+		cerr << "Event index is not used with raw input, entry numbers only exist in the ROOT files" << endl;
+		writeIndex = false;
+	}
+	if (rawInput && rawDataDir.empty()) throw invalid_argument(string(BOLDRED) + string("rawDataDir must be set in the config file for raw input") + string(RESET));
+
+	// Create the index directory now rather than failing after the sort
+	if (writeIndex) MakeOutputDir(indexDir, "indexDir");
 	
 	// Counters for certain particle combinations, using atomic to be thread-safe
 	// Start with 6Li -> npa
@@ -78,55 +257,85 @@ int main() {
 	atomic<size_t> count_ap2n{0};
 	atomic<size_t> count_ap3n{0};
 	atomic<size_t> count_missTDC{0};
+
+	// Dither seed of the next analysis task, so tasks do not share one sequence
+	atomic<unsigned int> ditherSeed{1};
 	
-	/******** EVENT PROCESSING LAMBDA FUNCTION ********/
-	
-	// Define the function that will process a subrange of the tree.
-	// The function must receive only one parameter, a TTreeReader,
-	// and it must be thread safe. To enforce the latter requirement,
-	// TBufferMerger::GetFile will be used for the output file.
-	auto f = [&](TTreeReader &reader) {
-		Input input(reader);
+	/******** EVENT PROCESSING LAMBDA FUNCTIONS ********/
+
+	// Analysis of all events of one task, shared by the TTree and raw input paths.
+	// next(run, entry) loads the next event into input and returns false once
+	// there are no more, setting the run number and entry of the event. The
+	// function must be thread safe, so TBufferMerger::GetFile is used for the output file.
+	auto analyzeTask = [&](Input& input, const function<bool(int&, long long&)>& next) {
 
 		// Output using thread safe file
-		auto f = merger.GetFile();
+		auto f = merger->GetFile();
 
 		const char* otname = sortConfig.GetOtreeName().c_str();
 
 		// Initialize analysis classes
 		event texneutevent;
 		histo Histo(f, texneutevent);
-		Gobbi gobbi(input, Histo, sortConfig, runnum, texneutevent);
+		Gobbi gobbi(input, Histo, context, runnum, texneutevent);
+
+		// Each task dithers with its own sequence. Seed 0 would make TRandom3 pick a random one
+		gobbi.Ran.SetSeed(ditherSeed.fetch_add(1));
 		
+		// Index records of this task, handed to indexBuilder when the run changes and at the end
+		vector<EventIndex::Record> indexRecords;
+		int indexRun = gobbi.runnum;
+
+		// TNLIB takes its hits as vectors, these are reused for every event of the task
+		vector<size_t> tn_chip, tn_chan, tn_a, tn_b, tn_c, tn_t;
+		vector<size_t> texneut_tdcchans;
+		vector<double> texneut_tdcts;
+
 		// Thread-local event loop
 		size_t localCounter = 0;
-		while (reader.Next()) {
+		int run = gobbi.runnum;
+		long long entry = 0;
+		while (next(run, entry)) {
 
-			// First, take input file from SpecTcl and refactor into usable hit list format
-			input.ReadAndRefactor();
+			// A task may move on to events from a different run
+			if (run != gobbi.runnum) gobbi.SetRun(run);
 			
 			// TexNeut analysis
-			vector<size_t> texneut_tdcchans;
-			vector<double> texneut_tdcts;
+			texneut_tdcchans.clear();
+			texneut_tdcts.clear();
 			input.GetTDC().FillTexNeutHitVectors(texneut_tdcchans, texneut_tdcts);
 			const Input::TexNeutInput& texin = input.GetTexNeut();
-			texneutevent.CustomFillNecessary(texin.GetNhits(), texin.chip, texin.chan, texin.a, texin.b, texin.c, texin.t, texneut_tdcchans, texneut_tdcts);
+			texin.FillTNLIBVectors(tn_chip, tn_chan, tn_a, tn_b, tn_c, tn_t);
+			texneutevent.CustomFillNecessary(texin.GetNhits(), tn_chip, tn_chan, tn_a, tn_b, tn_c, tn_t, texneut_tdcchans, texneut_tdcts);
 			texneutevent.analyse(texneut, 1234, Triple());
 			
 			// Gobbi analysis
 			gobbi.analyze();
+
+			// Only events with an identified particle or a neutron go in the index
+			if (writeIndex) {
+				if (gobbi.runnum != indexRun) {
+					indexBuilder.Add(indexRun, indexRecords);
+					indexRun = gobbi.runnum;
+				}
+				EventIndex::Record rec = gobbi.MakeIndexRecord(entry);
+				if (rec.tags != 0) indexRecords.push_back(rec);
+			}
 			
 			// Output
 			Histo.Fill();
 			
-			// Handle progress bar
+			// Handle progress bar, the number of entries is not known in advance for raw input
 			localCounter++;
 			if (localCounter >= updateRate) {
 				long long total = globalProcessed.fetch_add(localCounter);
 				lock_guard<mutex> lock(consoleMutex);
-				long double percentage = (long double)total / numentries * 100.0;
-				cout << "\r[ " << setw(7) << fixed << setprecision(4) 
-				     << percentage << "% ] Processing entries..." << setw(10) << " " << flush;
+				if (numentries > 0) {
+					long double percentage = (long double)total / numentries * 100.0;
+					cout << "\r[ " << setw(7) << fixed << setprecision(4) 
+					     << percentage << "% ] Processing entries..." << setw(10) << " " << flush;
+				}
+				else cout << "\r[ " << setw(12) << total << " ] Processing entries..." << setw(10) << " " << flush;
 
 				localCounter = 0;
 			}
@@ -140,51 +349,97 @@ int main() {
 		count_ap3n += gobbi.a_p_3n;
 		count_ap_withn += gobbi.a_p_withn;
 		count_missTDC += texneutevent.Getcount_missTDC();
+		if (writeIndex) indexBuilder.Add(indexRun, indexRecords);
 	};
-	
-	/******** RUN NUMBER LOOP ********/
-
-	string runNumbersFile = sortConfig.GetRunNumbersFile();
-	ifstream runFile(runNumbersFile);
-	if (runFile.fail()) throw invalid_argument(string(BOLDRED) + string("Run numbers file ") + runNumbersFile + std::string(" does not exist or failed to open") + std::string(RESET));
 
-	// First, loop through runs and find the total number of entries
-	string itname = sortConfig.GetItreeName();
-	ostringstream datastring;
-	for (;;) {
-		runFile >> runnum;
-		if (runFile.eof() || runFile.bad()) break;
+	// Define the function that will process a subrange of the tree.
+	// The function must receive only one parameter, a TTreeReader.
+	auto f = [&](TTreeReader &reader) {
+		layout.PinCurrentThread();
+		Input input(reader, inputMode);
+
+		TFile* treeFile = nullptr;
+		int treeRun = runnum;
+		analyzeTask(input, [&](int& run, long long& entry) {
+			if (!reader.Next()) return false;
+
+			// With the global scheduler a task may start on any run in the list, so
+			// look up the run of the file the current entry belongs to. The tree number
+			// is not used, TTreeProcessorMT gives each task a chain of its own file only
+			if (globalScheduler && reader.GetTree()->GetCurrentFile() != treeFile) {
+				treeFile = reader.GetTree()->GetCurrentFile();
+				size_t irun = find(runFiles.begin(), runFiles.end(), treeFile->GetName()) - runFiles.begin();
+				if (irun == runFiles.size()) throw invalid_argument(string(BOLDRED) + string("Input file ") + treeFile->GetName() + string(" is not one of the run files being sorted") + string(RESET));
+				treeRun = runFileRuns[irun];
+			}
+			run = treeRun;
+			entry = reader.GetTree()->GetTree()->GetReadEntry();
 
-		datastring.str("");
-		datastring << configFile.GetTNDataDir() << "run-" << runnum << ".root";
+			// First, take input file from SpecTcl and refactor into usable hit list format
+			input.ReadAndRefactor();
+			return true;
+		});
+	};
 
-		// Check status of input run data file
-		TFile *file = TFile::Open(datastring.str().c_str());
-		if (!file || file->IsZombie()) continue;
+	// Analysis thread for raw input, takes batches of events from the pipeline
+	auto fRaw = [&](RawPipeline& pipeline) {
+		layout.PinCurrentThread();
+		Input input(Input::Mode::Raw);
+
+		RawBatch batch;
+		size_t k = 0;
+		analyzeTask(input, [&](int& run, long long& entry) {
+			while (k >= batch.Size()) {
+				if (!pipeline.Pop(batch)) return false;
+				k = 0;
+			}
+			run = batch.run;
+			entry = batch.firstEntry + k;
+			input.ReadRaw(batch.Event(k), batch.EventWords(k));
+			k++;
+			return true;
+		});
+	};
+	
+	/******** RUN NUMBER LOOP ********/
 
-		// Check if tree exists in the file
-		TTree *tree = (TTree*)file->Get(itname.c_str());
-		if (!tree) {
-			file->Close();
-			continue;
+	if (rawInput) {
+		// The main thread reads the raw event files of each run in turn and
+		// hands batches of events to the analysis threads through a bounded queue
+		RawPipeline pipeline(4 * layout.GetNThreads(), 4096);
+		vector<thread> workers;
+		for (size_t i = 0; i < layout.GetNThreads(); i++) workers.emplace_back(fRaw, ref(pipeline));
+
+		for (int run : runNumbers) {
+			vector<string> segments = RawPipeline::FindSegments(rawDataDir, run);
+			if (segments.empty()) {
+				cerr << "No raw event files for run " << run << " in " << rawDataDir << "!" << endl;
+				continue;
+			}
+			size_t nevents = pipeline.ReadRun(segments, run);
+			lock_guard<mutex> lock(consoleMutex);
+			cout << "\nRead " << nevents << " physics events from " << segments.size() << " segment(s) of run " << run << endl;
 		}
-		numentries += tree->GetEntries();
-		file->Close();
+		pipeline.Close();
+		for (auto& worker : workers) worker.join();
+		cout << endl;
 	}
-
-	// Then, loop through run numbers from numbers.beam and perform analysis on each
-	runFile.clear();
-	runFile.seekg(0);
-	for (;;) {
-		runFile >> runnum;
-		if (runFile.eof() || runFile.bad()) break;
-
-		datastring.str("");
-		datastring << configFile.GetTNDataDir() << "run-" << runnum << ".root";
-
-		// Check status of input run data file
-		size_t numentries_singlefile;
-		{
+	else {
+		// First, loop through runs, check their input files and find the total number of entries.
+		// In sparse mode the hit-list files written by --convert are read instead of the SpecTcl files.
+		const bool sparseInput = (inputMode == Input::Mode::Sparse);
+		string itname = sparseInput ? string(HitList::TreeName) : sortConfig.GetItreeName();
+		ostringstream datastring;
+		vector<size_t> runEntries;
+		vector<vector<long long>> runSelections; // selected entries of each run, if selecting from the index
+		for (int run : runNumbers) {
+			runnum = run;
+
+			datastring.str("");
+			if (sparseInput) datastring << hitListDir << HitList::FileName(runnum);
+			else datastring << configFile.GetTNDataDir() << "run-" << runnum << ".root";
+
+			// Check status of input run data file
 			TFile *file = TFile::Open(datastring.str().c_str());
 			if (!file || file->IsZombie()) {
 				cerr << "Error opening file for run " << runnum << "!" << endl;
@@ -198,18 +453,86 @@ int main() {
 				file->Close();
 				continue;
 			}
-			numentries_singlefile = tree->GetEntries();
+			size_t treeEntries = tree->GetEntries();
 			file->Close();
+
+			// With a selection only the listed entries are counted and later processed
+			if (selectMask != 0) {
+				try {
+					EventIndex index(indexDir + EventIndex::FileName(runnum));
+					runSelections.push_back(index.Select(selectMask));
+				}
+				catch (const exception& e) {
+					cerr << e.what() << endl;
+					continue;
+				}
+				runFiles.push_back(datastring.str());
+				runFileRuns.push_back(runnum);
+				runEntries.push_back(runSelections.back().size());
+				numentries += runSelections.back().size();
+				continue;
+			}
+
+			// Every sorted run gets an index, possibly empty, so none is left from an earlier sort
+			if (writeIndex) indexBuilder.AddRun(runnum);
+			runFiles.push_back(datastring.str());
+			runFileRuns.push_back(runnum);
+			runEntries.push_back(treeEntries);
+			numentries += treeEntries;
 		}
 
-		cout << "Processing TTree in file: " << datastring.str() << " (" << numentries_singlefile << ")" << endl;
+		if (selectMask != 0) {
+			// Visit only the selected entries of each run. Runs are processed in turn,
+			// since a TTreeProcessorMT with an entry list covers a single tree.
+			cout << "Processing " << numentries << " events selected by '" << sortConfig.GetIndexSelect() << "' from the event index" << endl;
+			for (size_t irun = 0; irun < runFiles.size(); irun++) {
+				if (runSelections[irun].empty()) continue;
+				runnum = runFileRuns[irun];
+				cout << "Processing TTree in file: " << runFiles[irun] << " (" << runEntries[irun] << " selected)" << endl;
+
+				TEntryList entries("selected", "Entries selected from the event index", itname.c_str(), runFiles[irun].c_str());
+				for (long long entry : runSelections[irun]) entries.Enter(entry);
+
+				unique_ptr<TFile> file(TFile::Open(runFiles[irun].c_str()));
+				TTree* tree = (TTree*)file->Get(itname.c_str());
+				ROOT::TTreeProcessorMT tp(*tree, entries);
+				tp.Process(f);
+				cout << endl;
+			}
+		}
+		else if (globalScheduler && !runFiles.empty()) {
+			// Build a single TTreeProcessorMT over every run file, so that the clusters
+			// of all runs form one global work queue and no run acts as a barrier
+			cout << "Processing " << runFiles.size() << " run files (" << numentries << " entries) with the global scheduler" << endl;
+			vector<string_view> fileViews(runFiles.begin(), runFiles.end());
+			ROOT::TTreeProcessorMT tp(fileViews, itname);
+			tp.Process(f);
+			cout << endl;
+		}
+		else {
+			// Perform analysis on each run in turn
+			for (size_t irun = 0; irun < runFiles.size(); irun++) {
+				runnum = runFileRuns[irun];
+				cout << "Processing TTree in file: " << runFiles[irun] << " (" << runEntries[irun] << ")" << endl;
+
+				// Create a TTreeProcessorMT: this class orchestrates the parallel processing of an input tree
+				ROOT::TTreeProcessorMT tp(runFiles[irun], itname);
+
+				// Execute multi-threaded tree processing
+				tp.Process(f);
+				cout << endl;
+			}
+		}
+	}
 
-		// Create a TTreeProcessorMT: this class orchestrates the parallel processing of an input tree
-		ROOT::TTreeProcessorMT tp(datastring.str().c_str(), itname.c_str());
+	if (writeIndex) indexBuilder.WriteAll(indexDir);
 
-		// Execute multi-threaded tree processing
-		tp.Process(f);
-		cout << endl;
+	// Close the merged tpar output, then add the spectra of all threads to it once
+	merger.reset();
+	{
+		TFile ofile(ofname.c_str(), "UPDATE");
+		if (ofile.IsZombie()) throw invalid_argument(string(BOLDRED) + string("Cannot reopen ") + ofname + string(" to write histograms") + string(RESET));
+		HistStore::Write(&ofile);
 	}
 
 	// Output program duration